@@ -10,6 +10,7 @@
 
 #include "actions-base.h"
 
+#include <fstream>
 #include <iostream>
 
 #include <giomm.h>  // Not <gtkmm.h>! To eventually allow a headless version!
@@ -31,6 +32,7 @@
 #include "util-string/ustring-format.h"
 #include "io/resource.h"
 #include "object/sp-root.h"       // query_all()
+#include "ui/widget/canvas/framecheck.h" // Rendering statistics
 
 void
 print_inkscape_version()
@@ -71,6 +73,29 @@ print_user_data_directory()
     show_output(Inkscape::IO::Resource::profile_path(), false);
 }
 
+void
+print_render_counters()
+{
+    Glib::ustring out;
+    for (auto const &[name, value] : Inkscape::FrameCheck::get_counters()) {
+        out += name + "=" + std::to_string(value) + "\n";
+    }
+    show_output(out, false);
+}
+
+void
+export_render_trace()
+{
+    auto const path = Glib::build_filename(Glib::get_tmp_dir(), "framecheck.json");
+    auto file = std::ofstream(path, std::ios_base::out | std::ios_base::binary);
+    Inkscape::FrameCheck::write_chrome_trace(file);
+    if (!file) {
+        show_output("render-trace: failed to write " + path);
+        return;
+    }
+    show_output(path, false);
+}
+
 // Helper function for query_x(), query_y(), query_width(), and query_height().
 void
 query_dimension(InkscapeApplication* app, bool extent, Geom::Dim2 const axis)
@@ -214,6 +239,8 @@ std::vector<std::vector<Glib::ustring>> raw_data_base =
     {"app.list-input-types",      N_("List Input File Extensions"), SECTION_BASE,    N_("Print a list of input file extensions and exit")    },
     {"app.quit",                  N_("Quit"),                       SECTION_BASE,    N_("Quit Inkscape, check for data loss")                },
     {"app.quit-immediate",        N_("Quit Immediately"),           SECTION_BASE,    N_("Immediately quit Inkscape, no check for data loss") },
+    {"app.render-counters",       N_("Rendering Counters"),         SECTION_BASE,    N_("Print rendering statistics such as cache hits, recorded while Framecheck is enabled") },
+    {"app.render-trace",          N_("Export Rendering Trace"),     SECTION_BASE,    N_("Write recorded rendering events to a Chrome trace file and print its path") },
 
     {"app.open-page",             N_("Import Page Number"),            SECTION_IMPORT, N_("Select PDF page number to import")                   },
     {"app.convert-dpi-method",    N_("Import DPI Method"),             SECTION_IMPORT, N_("Set DPI conversion method for legacy Inkscape files")},
@@ -244,6 +271,8 @@ add_actions_base(InkscapeApplication* app)
     gapp->add_action(               "list-input-types",   sigc::mem_fun(*app, &InkscapeApplication::print_input_type_list)                        );
     gapp->add_action(               "quit",               sigc::mem_fun(*app, &InkscapeApplication::on_quit)                                      );
     gapp->add_action(               "quit-immediate",     sigc::mem_fun(*app, &InkscapeApplication::on_quit_immediate)                            );
+    gapp->add_action(               "render-counters",                                     sigc::ptr_fun(&print_render_counters)                  );
+    gapp->add_action(               "render-trace",                                        sigc::ptr_fun(&export_render_trace)                    );
 
     gapp->add_action_radio_integer( "open-page",                                           sigc::ptr_fun(&pdf_page),                             0);
     gapp->add_action_radio_string(  "convert-dpi-method",                                  sigc::ptr_fun(&convert_dpi_method),              "none");
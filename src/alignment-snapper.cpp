@@ -10,6 +10,8 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
 #include <2geom/circle.h>
@@ -33,6 +35,7 @@ Inkscape::AlignmentSnapper::AlignmentSnapper(SnapManager *sm, Geom::Coord const
     : Snapper(sm, d)
 {
     _points_to_snap_to = std::make_unique<std::vector<Inkscape::SnapCandidatePoint>>();
+    _points_index = std::make_unique<SnapCandidatePointIndex>();
 }
 
 Inkscape::AlignmentSnapper::~AlignmentSnapper()
@@ -46,6 +49,7 @@ void Inkscape::AlignmentSnapper::_collectBBoxPoints(bool const &first_point) con
         return;
 
     _points_to_snap_to->clear();
+    _points_index->clear();
     SPItem::BBoxType bbox_type = SPItem::GEOMETRIC_BBOX;
 
     Preferences *prefs = Preferences::get();
@@ -120,9 +124,12 @@ void Inkscape::AlignmentSnapper::_snapBBoxPoints(IntermSnapResults &isr,
                                                  Geom::Point const &p_proj_on_constraint) const
 {
 
-    _collectBBoxPoints(p.getSourceNum() <= 0);
+    bool const first_point = p.getSourceNum() <= 0;
+    _collectBBoxPoints(first_point);
 
-    if (unselected_nodes != nullptr &&
+    // The unselected nodes don't change during a drag, so only add them along with the other points
+    if (first_point &&
+        unselected_nodes != nullptr &&
         unselected_nodes->size() > 0 &&
         _snapmanager->snapprefs.isTargetSnappable(Inkscape::SNAPTARGET_ALIGNMENT_HANDLE)) {
         g_assert(_points_to_snap_to != nullptr);
@@ -140,8 +147,37 @@ void Inkscape::AlignmentSnapper::_snapBBoxPoints(IntermSnapResults &isr,
     bool intersection = false;
     bool strict_snapping = _snapmanager->snapprefs.getStrictSnapping();
     bool always = getSnapperAlwaysSnap(p.getSourceType());
+    Geom::Coord const tol = getSnapperTolerance();
 
-    for (const auto & k : *_points_to_snap_to) {
+    if (!c.isUndefined() && c.isLinear()) {
+        if (c.getDirection().x() == 0)
+            consider_y = false; // consider vertical snapping if moving vertically
+        else
+            consider_x = false; // consider horizontal snapping if moving horizontally 
+    }
+
+    // Only the points level with or above/below the source can be aligned to. For all but the
+    // first point of a snap, look these up in the index instead of scanning every point.
+    std::vector<int> candidates;
+    if (!first_point) {
+        if (!_points_index->built()) {
+            _points_index->build(*_points_to_snap_to);
+        }
+        auto const pt = p.getPoint();
+        if (consider_x) {
+            candidates = _points_index->queryBand(Geom::Y, pt.y() - tol, pt.y() + tol);
+        }
+        if (consider_y) {
+            auto const band = _points_index->queryBand(Geom::X, pt.x() - tol, pt.x() + tol);
+            std::vector<int> merged;
+            std::set_union(candidates.begin(), candidates.end(), band.begin(), band.end(), std::back_inserter(merged));
+            candidates = std::move(merged);
+        }
+    }
+
+    auto const count = first_point ? _points_to_snap_to->size() : candidates.size();
+    for (std::size_t n = 0; n < count; n++) {
+        auto const &k = (*_points_to_snap_to)[first_point ? n : candidates[n]];
         if (_allowSourceToSnapToTarget(p.getSourceType(), k.getTargetType(), strict_snapping)) {
             Geom::Point target_pt = k.getPoint();
             // (unconstrained) distance from HORIZONTAL guide 
@@ -152,13 +188,6 @@ void Inkscape::AlignmentSnapper::_snapBBoxPoints(IntermSnapResults &isr,
             Geom::Point point_on_y(target_pt.x(), p.getPoint().y());
             Geom::Coord distY = Geom::L2(point_on_y - p.getPoint()); 
 
-            if (!c.isUndefined() && c.isLinear()) {
-                if (c.getDirection().x() == 0)
-                    consider_y = false; // consider vertical snapping if moving vertically
-                else
-                    consider_x = false; // consider horizontal snapping if moving horizontally 
-            }
-
             bool is_target_node = k.getTargetType() & SNAPTARGET_NODE_CATEGORY;
             if (consider_x && distX < getSnapperTolerance() && Geom::L2(target_pt - point_on_x) < sx.getDistanceToAlignTarget()) {
                 sx = SnappedPoint(point_on_x,
@@ -17,6 +17,7 @@
 #include "snap-enums.h"
 #include "snapper.h"
 #include "snap-candidate.h"
+#include "snap-candidate-index.h"
 
 class SPDesktop;
 class SPNamedView;
@@ -64,6 +65,7 @@ public:
 
 private:
     std::unique_ptr<std::vector<SnapCandidatePoint>> _points_to_snap_to;
+    std::unique_ptr<SnapCandidatePointIndex> _points_index;
 
     /** Collects and caches points on bounding boxes of the candidates
      * @param is the point first point in the selection?
@@ -605,7 +605,7 @@ SPDesktop::zoom_drawing()
     SPItem *docitem = doc()->getRoot();
     g_return_if_fail (docitem != nullptr);
 
-    docitem->bbox_valid = FALSE;
+    docitem->invalidateBoundsCache();
     Geom::OptRect d = docitem->desktopVisualBounds();
 
     /* Note that the second condition here indicates that
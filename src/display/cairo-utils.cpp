@@ -600,6 +600,54 @@ guchar const *Pixbuf::getMimeData(gsize &len, std::string &mimetype) const
     return data;
 }
 
+/** Tags the surface with a CAIRO_MIME_TYPE_UNIQUE_ID derived from the image content.
+ * Vector backends (PDF, PS) use this ID to embed each distinct image only once, even when
+ * it is drawn from several Pixbuf objects, e.g. repeated <image> elements with the same href.
+ * The original compressed data is hashed if available, otherwise the decoded pixels. */
+void Pixbuf::ensureUniqueId() const
+{
+    auto surface = const_cast<cairo_surface_t *>(_surface);
+
+    unsigned char const *existing = nullptr;
+    unsigned long existing_len = 0;
+    cairo_surface_get_mime_data(surface, CAIRO_MIME_TYPE_UNIQUE_ID, &existing, &existing_len);
+    if (existing) {
+        return;
+    }
+
+    GChecksum *checksum = g_checksum_new(G_CHECKSUM_SHA256);
+
+    gsize len = 0;
+    std::string mimetype;
+    if (auto data = getMimeData(len, mimetype)) {
+        g_checksum_update(checksum, reinterpret_cast<guchar const *>(mimetype.c_str()), mimetype.size());
+        g_checksum_update(checksum, data, len);
+    } else {
+        cairo_surface_flush(surface);
+        int const w = cairo_image_surface_get_width(surface);
+        int const h = cairo_image_surface_get_height(surface);
+        int const stride = cairo_image_surface_get_stride(surface);
+        auto const format = cairo_image_surface_get_format(surface);
+        guchar const *px = cairo_image_surface_get_data(surface);
+        if (!px) {
+            g_checksum_free(checksum);
+            return;
+        }
+        gint32 const header[] = { w, h, static_cast<gint32>(format) };
+        g_checksum_update(checksum, reinterpret_cast<guchar const *>(header), sizeof(header));
+        // Hash only the visible part of each row; stride padding is uninitialized.
+        int const row_bytes = cairo_format_stride_for_width(format, w);
+        for (int y = 0; y < h; ++y) {
+            g_checksum_update(checksum, px + y * stride, std::min(row_bytes, stride));
+        }
+    }
+
+    gchar *id = g_strdup(g_checksum_get_string(checksum));
+    g_checksum_free(checksum);
+    cairo_surface_set_mime_data(surface, CAIRO_MIME_TYPE_UNIQUE_ID, reinterpret_cast<guchar const *>(id),
+                                strlen(id), g_free, id);
+}
+
 int Pixbuf::width() const {
     return gdk_pixbuf_get_width(const_cast<GdkPixbuf*>(_pixbuf));
 }
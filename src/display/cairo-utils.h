@@ -59,6 +59,7 @@ public:
 
     bool hasMimeData() const;
     guchar const *getMimeData(gsize &len, std::string &mimetype) const;
+    void ensureUniqueId() const;
     std::string const &originalPath() const { return _path; }
     time_t modificationTime() const { return _mod_time; }
 
@@ -32,6 +32,7 @@ struct CanvasItemBuffer
     int device_scale; // For high DPI monitors.
     Cairo::RefPtr<Cairo::Context> cr;
     bool outline_pass;
+    bool draft = false; // Render the drawing quickly at reduced quality.
 };
 
 } // namespace Inkscape
@@ -113,7 +113,7 @@ void CanvasItemDrawing::_update(bool)
 void CanvasItemDrawing::_render(Inkscape::CanvasItemBuffer &buf) const
 {
     auto dc = Inkscape::DrawingContext(buf.cr->cobj(), buf.rect.min());
-    _drawing->render(dc, buf.rect, buf.outline_pass * DrawingItem::RENDER_OUTLINE);
+    _drawing->render(dc, buf.rect, buf.outline_pass * DrawingItem::RENDER_OUTLINE | buf.draft * DrawingItem::RENDER_DRAFT);
 }
 
 /**
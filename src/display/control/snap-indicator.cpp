@@ -146,12 +146,9 @@ SnapIndicator::set_new_snaptarget(Inkscape::SnappedPoint const &p, bool pre_snap
     bool is_alignment = p.getAlignmentTarget().has_value();
     bool is_distribution = p.getTarget() & SNAPTARGET_DISTRIBUTION_CATEGORY;
 
-    Inkscape::Preferences *prefs = Inkscape::Preferences::get();
-    double scale = prefs->getDouble("/tools/measure/scale", 100.0) / 100.0;
+    double scale = _measure_scale / 100.0;
 
-    bool value = prefs->getBool("/options/snapindicator/value", true);
-
-    if (value) {
+    if (_show_indicator) {
         Glib::ustring target_name = _("UNDEFINED");
         Glib::ustring source_name = _("UNDEFINED");
 
@@ -169,7 +166,7 @@ SnapIndicator::set_new_snaptarget(Inkscape::SnappedPoint const &p, bool pre_snap
 
         remove_snapsource(); // Don't set both the source and target indicators, as these will overlap
 
-        double timeout_val = prefs->getDouble("/options/snapindicatorpersistence/value", 2.0);
+        double timeout_val = _persistence;
         if (timeout_val < 0.1) {
             timeout_val = 0.1; // a zero value would mean infinite persistence (i.e. until new snap occurs)
             // Besides, negatives values would ....?
@@ -177,7 +174,7 @@ SnapIndicator::set_new_snaptarget(Inkscape::SnappedPoint const &p, bool pre_snap
 
         // TODO: should this be a constant or a separate prefrence
         // we are using the preference of measure tool here.
-        double fontsize = prefs->getDouble("/tools/measure/fontsize", 10.0);
+        double fontsize = _measure_fontsize;
 
         if (is_distribution) {
             make_distribution_indicators(p, fontsize, scale);
@@ -296,10 +293,7 @@ SnapIndicator::set_new_snapsource(Inkscape::SnapCandidatePoint const &p)
 
     g_assert(_desktop != nullptr); // If this fails, then likely setup() has not been called on the snap manager (see snap.cpp -> setup())
 
-    Inkscape::Preferences *prefs = Inkscape::Preferences::get();
-    bool value = prefs->getBool("/options/snapindicator/value", true);
-
-    if (value) {
+    if (_show_indicator) {
         auto ctrl = new Inkscape::CanvasItemCtrl(_desktop->getCanvasTemp(), Inkscape::CANVAS_ITEM_CTRL_TYPE_POINT);
         ctrl->set_position(p.getPoint());
         _snapsource = _desktop->add_temporary_canvasitem(ctrl, 1000);
@@ -397,8 +391,7 @@ void SnapIndicator::make_alignment_indicator(Geom::Point const &p1, Geom::Point
     //make sure the line is straight
     g_assert(p1.x() == p2.x() || p1.y() == p2.y());
 
-    Preferences *prefs = Preferences::get();
-    bool show_distance = prefs->getBool("/options/snapindicatordistance/value", false);
+    bool const show_distance = _show_distance;
 
     Inkscape::CanvasItemCurve *line;
 
@@ -474,8 +467,7 @@ void SnapIndicator::make_distribution_indicators(SnappedPoint const &p,
                                                 double fontsize,
                                                 double scale)
 {
-    Preferences *prefs = Preferences::get();
-    bool show_distance = prefs->getBool("/options/snapindicatordistance/value", false);
+    bool const show_distance = _show_distance;
 
     guint32 color = 0xff5f1fff;
     guint32 text_fill = 0xffffffff;
@@ -17,10 +17,12 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include "preferences.h"
 #include "snap-enums.h"
 #include "snapped-point.h"
 #include "display/control/canvas-item-curve.h"
 
+#include <cfloat>
 #include <glib.h>
 #include <glibmm/i18n.h>
 
@@ -61,6 +63,14 @@ private:
     SnapIndicator(const SnapIndicator&) = delete;
     SnapIndicator& operator=(const SnapIndicator&) = delete;
 
+    // Read on every snap event
+    Pref<bool> _show_indicator = {"/options/snapindicator/value", true};
+    Pref<bool> _show_distance = {"/options/snapindicatordistance/value", false};
+    Pref<double> _persistence = {"/options/snapindicatorpersistence/value", 2.0, -DBL_MAX, DBL_MAX};
+    // We are using the preferences of the measure tool here.
+    Pref<double> _measure_scale = {"/tools/measure/scale", 100.0, -DBL_MAX, DBL_MAX};
+    Pref<double> _measure_fontsize = {"/tools/measure/fontsize", 10.0, -DBL_MAX, DBL_MAX};
+
     void make_distribution_indicators(SnappedPoint const &p, double fontsize, double scale);
     void make_alignment_indicator(Geom::Point const &p1, Geom::Point const &p2, guint32 color, double fontsize, double scale);
     guint32 get_guide_color(SnapTargetType t);
@@ -25,6 +25,7 @@
 
 #include "display/control/canvas-item-drawing.h"
 #include "ui/widget/canvas.h" // Mark area for redrawing.
+#include "ui/widget/canvas/framecheck.h" // For profiling.
 
 #include "nr-filter.h"
 #include "style.h"
@@ -32,6 +33,12 @@
 #include "object/sp-item.h"
 
 static constexpr auto CACHE_SCORE_THRESHOLD = 50000.0; ///< Do not consider objects for caching below this score.
+static constexpr auto DRAFT_MAX_FILTER_COMPLEXITY = 5000.0; ///< Filters more complex than this are skipped by draft renders.
+
+// Cache statistics, for profiling.
+static Inkscape::FrameCheck::Counter cache_hits("drawing-cache-hits");
+static Inkscape::FrameCheck::Counter cache_partial_hits("drawing-cache-partial-hits");
+static Inkscape::FrameCheck::Counter cache_misses("drawing-cache-misses");
 
 namespace Inkscape {
 
@@ -703,7 +710,8 @@ struct MaskLuminanceToAlpha
 unsigned DrawingItem::render(DrawingContext &dc, RenderContext &rc, Geom::IntRect const &area, unsigned flags, DrawingItem const *stop_at) const
 {
     bool const outline = flags & RENDER_OUTLINE;
-    bool const render_filters = !(flags & RENDER_NO_FILTERS);
+    // Draft renders skip filters too complex to render interactively.
+    bool const render_filters = !(flags & RENDER_NO_FILTERS) && !(rc.draft && _filter && _filter->complexity(_ctm) > DRAFT_MAX_FILTER_COMPLEXITY);
     bool const forcecache = _filter && render_filters;
 
     // stop_at is handled in DrawingGroup, but this check is required to handle the case
@@ -753,8 +761,27 @@ unsigned DrawingItem::render(DrawingContext &dc, RenderContext &rc, Geom::IntRec
 
     std::unique_lock<std::mutex> lock;
 
+    // Draft renders must not leave reduced-quality content in the cache, so only use it if it can paint the whole area.
+    bool use_cache = _cache && !(flags & RENDER_BYPASS_CACHE);
+    if (use_cache && rc.draft) {
+        auto const cache_lock = std::lock_guard(_cache->mutables);
+        if (_cache->surface && _cache->surface->device_scale() == device_scale) {
+            _cache->surface->prepare();
+            if (_cache->surface->isClean(*carea)) {
+                dc.setOperator(ink_css_blend_to_cairo_operator(_blend_mode));
+                dc.rectangle(*carea);
+                dc.setSource(&*_cache->surface);
+                dc.fill();
+                dc.setSource(0, 0, 0, 0);
+                cache_hits.add();
+                return RENDER_OK;
+            }
+        }
+        use_cache = false;
+    }
+
     // Render from cache if possible, unless requested not to (hatches).
-    if (_cache && !(flags & RENDER_BYPASS_CACHE)) {
+    if (use_cache) {
         lock = std::unique_lock(_cache->mutables);
 
         if (_cache->surface) {
@@ -766,8 +793,10 @@ unsigned DrawingItem::render(DrawingContext &dc, RenderContext &rc, Geom::IntRec
             _cache->surface->paintFromCache(dc, carea, forcecache);
             if (!carea) {
                 dc.setSource(0, 0, 0, 0);
+                cache_hits.add();
                 return RENDER_OK;
             }
+            cache_partial_hits.add();
         } else {
             // There is no cache. This could be because caching of this item
             // was just turned on after the last update phase, or because
@@ -776,6 +805,7 @@ unsigned DrawingItem::render(DrawingContext &dc, RenderContext &rc, Geom::IntRec
             if (!cl)
                 cl = carea;
             _cache->surface.emplace(*cl, device_scale);
+            cache_misses.add();
         }
 
         if (!forcecache) {
@@ -909,7 +939,7 @@ unsigned DrawingItem::render(DrawingContext &dc, RenderContext &rc, Geom::IntRec
     ict.paint();
 
     // 6. Paint the completed rendering onto the base context (or into cache)
-    if (_cache && !(flags & RENDER_BYPASS_CACHE)) {
+    if (use_cache) {
         if (!forcecache) {
             lock.lock(); // Only hold the lock for the full duration of rendering for filters.
         }
@@ -946,7 +976,8 @@ unsigned DrawingItem::render(DrawingContext &dc, Geom::IntRect const &area, unsi
     auto rc = RenderContext{
         .outline_color = 0xff,
         .antialiasing_override = _drawing._antialiasing_override,
-        .dithering = _drawing._use_dithering
+        .dithering = _drawing._use_dithering,
+        .draft = static_cast<bool>(flags & RENDER_DRAFT)
     };
     return render(dc, rc, area, flags);
 }
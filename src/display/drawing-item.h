@@ -53,6 +53,7 @@ struct RenderContext
     std::uint32_t outline_color;
     std::optional<Antialiasing> antialiasing_override;
     bool dithering = false;
+    bool draft = false; ///< Render quickly at reduced quality, for interactive use. See DrawingItem::RENDER_DRAFT.
 };
 
 struct UpdateContext
@@ -89,7 +90,8 @@ public:
         RENDER_FILTER_BACKGROUND = 1 << 2,
         RENDER_OUTLINE           = 1 << 3,
         RENDER_NO_FILTERS        = 1 << 4,
-        RENDER_VISIBLE_HAIRLINES = 1 << 5
+        RENDER_VISIBLE_HAIRLINES = 1 << 5,
+        RENDER_DRAFT             = 1 << 6  // Lowest filter and blur quality, skip complex filters, and leave caches untouched.
     };
     enum StateFlags
     {
@@ -275,6 +275,15 @@ void DrawingCache::paintFromCache(DrawingContext &dc, Geom::OptIntRect &area, bo
     cairo_region_destroy(cache_region);
 }
 
+/**
+ * Check whether the whole of an area can be painted from the cache.
+ */
+bool DrawingCache::isClean(Geom::IntRect const &area) const
+{
+    auto const area_c = geom_to_cairo(area);
+    return cairo_region_contains_rectangle(_clean_region, &area_c) == CAIRO_REGION_OVERLAP_IN;
+}
+
 // debugging utility
 void DrawingCache::_dumpCache(Geom::OptIntRect const &area)
 {
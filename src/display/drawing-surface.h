@@ -72,6 +72,7 @@ public:
     void scheduleTransform(Geom::IntRect const &new_area, Geom::Affine const &trans);
     void prepare();
     void paintFromCache(DrawingContext &dc, Geom::OptIntRect &area, bool is_filter);
+    bool isClean(Geom::IntRect const &area) const;
 
 protected:
     cairo_region_t *_clean_region;
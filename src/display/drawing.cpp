@@ -243,7 +243,8 @@ void Drawing::render(DrawingContext &dc, Geom::IntRect const &area, unsigned fla
     auto rc = RenderContext{
         .outline_color = 0xff,
         .antialiasing_override = _antialiasing_override,
-        .dithering = _use_dithering
+        .dithering = _use_dithering,
+        .draft = static_cast<bool>(flags & DrawingItem::RENDER_DRAFT)
     };
     flags |= rendermode_to_renderflags(_rendermode);
 
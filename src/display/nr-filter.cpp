@@ -38,6 +38,7 @@
 #include "display/nr-filter-specularlighting.h"
 #include "display/nr-filter-tile.h"
 #include "display/nr-filter-turbulence.h"
+#include "ui/widget/canvas/framecheck.h"
 
 #include "display/cairo-utils.h"
 #include "display/drawing.h"
@@ -111,6 +112,10 @@ int Filter::render(Inkscape::DrawingItem const *item, DrawingContext &graphic, D
     }
     FilterQuality filterquality = (FilterQuality)item->drawing().filterQuality();
     int blurquality = item->drawing().blurQuality();
+    if (rc.draft) {
+        filterquality = FILTER_QUALITY_WORST;
+        blurquality = BLUR_QUALITY_WORST;
+    }
 
     Geom::Affine trans = item->ctm();
 
@@ -152,6 +157,10 @@ int Filter::render(Inkscape::DrawingItem const *item, DrawingContext &graphic, D
     auto slot = FilterSlot(bgdc, graphic, units, rc, blurquality);
 
     for (auto &i : primitives) {
+        FrameCheck::Event fc;
+        if (FrameCheck::is_enabled()) {
+            fc = FrameCheck::Event(FrameCheck::intern("filter: " + i->name().raw()));
+        }
         i->render_cairo(slot);
     }
 
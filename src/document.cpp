@@ -35,6 +35,7 @@
 
 #include "document.h"
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <cstring>
@@ -70,6 +71,7 @@
 #include "display/drawing.h"
 #include "io/dir-util.h"
 #include "live_effects/lpeobject.h"
+#include "object/deferred-build.h"
 #include "object/persp3d.h"
 #include "object/sp-defs.h"
 #include "object/sp-factory.h"
@@ -96,8 +98,15 @@ constexpr auto SP_DOCUMENT_UPDATE_PRIORITY = G_PRIORITY_HIGH_IDLE - 2;
 // since we want it to happen when there are no more updates.
 constexpr auto SP_DOCUMENT_REROUTING_PRIORITY = G_PRIORITY_HIGH_IDLE - 1;
 
+// Minimum time between connector reroutings, in microseconds. Shape moves queued in between
+// are gathered into a single libavoid transaction, so rerouting happens at most once per frame.
+constexpr gint64 SP_DOCUMENT_REROUTING_INTERVAL = 1000000 / 60;
+
 bool sp_no_convert_text_baseline_spacing = false;
 
+// Set while documents created on this thread should be built lazily, see SPDocument::lazy_build_scope.
+static thread_local bool lazy_build_requested = false;
+
 static int doc_count = 0;
 static int doc_mem_count = 0;
 
@@ -173,6 +182,9 @@ SPDocument::~SPDocument() {
     DocumentUndo::clearRedo(this);
     DocumentUndo::clearUndo(this);
 
+    // Whatever is still unbuilt is simply dropped along with the XML.
+    _deferred_build.reset();
+
     if (root) {
         root->releaseReferences();
         sp_object_unref(root);
@@ -399,6 +411,10 @@ std::unique_ptr<SPDocument> SPDocument::createDoc(
     	throw;
     }
 
+    if (lazy_build_requested && !parent) {
+        document->_deferred_build = std::make_unique<Inkscape::DeferredBuild>(document.get());
+    }
+
     // Recursively build object tree
     document->root->invoke_build(document.get(), rroot, false);
 
@@ -1164,6 +1180,8 @@ SPObject *SPDocument::getObjectById(std::string const &id) const
 
     if (auto rv = iddef.find(id); rv != iddef.end()) {
         return rv->second;
+    } else if (_deferred_build && !_deferred_build->empty() && _deferred_build->buildById(id)) {
+        return getObjectById(id);
     } else if (_parent_document) {
         return _parent_document->getObjectById(id);
     } else if (_ref_document) {
@@ -1179,6 +1197,8 @@ SPObject *SPDocument::getObjectById(char const *id) const
 
     if (auto rv = iddef.find(id); rv != iddef.end()) {
         return rv->second;
+    } else if (_deferred_build && !_deferred_build->empty() && _deferred_build->buildById(id)) {
+        return getObjectById(id);
     } else if (_parent_document) {
         return _parent_document->getObjectById(id);
     } else if (_ref_document) {
@@ -1231,6 +1251,9 @@ static void _getObjectsByClassRecursive(Glib::ustring const &klass, SPObject *pa
 std::vector<SPObject*> SPDocument::getObjectsByClass(Glib::ustring const &klass) const
 {
     if (klass.empty()) return {};
+    if (_deferred_build) {
+        _deferred_build->buildAll();
+    }
     std::vector<SPObject*> objects;
     _getObjectsByClassRecursive(klass, root, objects);
     return objects;
@@ -1258,6 +1281,9 @@ static void _getObjectsByElementRecursive(Glib::ustring const &element,
 std::vector<SPObject*> SPDocument::getObjectsByElement(Glib::ustring const &element, bool custom) const
 {
     if (element.empty()) return {};
+    if (_deferred_build) {
+        _deferred_build->buildAll();
+    }
     std::vector<SPObject*> objects;
     _getObjectsByElementRecursive(element, root, objects, custom);
     return objects;
@@ -1284,6 +1310,9 @@ static void _getObjectsBySelectorRecursive(SPObject *parent,
 std::vector<SPObject*> SPDocument::getObjectsBySelector(Glib::ustring const &selector) const
 {
     if (selector.empty()) return {};
+    if (_deferred_build) {
+        _deferred_build->buildAll();
+    }
 
     static CRSelEng *sel_eng = nullptr;
     if (!sel_eng) {
@@ -1321,6 +1350,25 @@ std::string SPDocument::generate_unique_id(char const *prefix)
     return result;
 }
 
+std::string SPDocument::generate_unique_id(std::string const &base, unsigned long after)
+{
+    auto &last = id_suffix_counters[base];
+    auto counter = std::max(after, last);
+
+    auto result = base;
+    while (true) {
+        ++counter;
+        result.replace(base.size(), std::string::npos, std::to_string(counter));
+
+        if (!getObjectById(result)) {
+            break;
+        }
+    }
+
+    last = counter;
+    return result;
+}
+
 void SPDocument::bindObjectToRepr(Inkscape::XML::Node *repr, SPObject *object)
 {
     if (object) {
@@ -1338,6 +1386,9 @@ SPObject *SPDocument::getObjectByRepr(Inkscape::XML::Node *repr) const
 {
     if (!repr) return nullptr;
     auto it = reprdef.find(repr);
+    if (it == reprdef.end() && _deferred_build && _deferred_build->buildByNode(repr)) {
+        it = reprdef.find(repr);
+    }
     return it == reprdef.end() ? nullptr : it->second;
 }
 
@@ -1400,9 +1451,17 @@ void SPDocument::requestModified()
     }
 
     if (rerouting_connection.empty()) {
-        rerouting_connection =
-            Glib::signal_idle().connect(sigc::mem_fun(*this, &SPDocument::rerouting_handler),
-                                        SP_DOCUMENT_REROUTING_PRIORITY);
+        auto const wait = _last_rerouting + SP_DOCUMENT_REROUTING_INTERVAL - g_get_monotonic_time();
+        if (wait > 0) {
+            // We rerouted very recently, e.g. for the previous motion event of a drag; wait for the next frame.
+            rerouting_connection =
+                Glib::signal_timeout().connect(sigc::mem_fun(*this, &SPDocument::rerouting_handler),
+                                               (wait + 999) / 1000, SP_DOCUMENT_REROUTING_PRIORITY);
+        } else {
+            rerouting_connection =
+                Glib::signal_idle().connect(sigc::mem_fun(*this, &SPDocument::rerouting_handler),
+                                            SP_DOCUMENT_REROUTING_PRIORITY);
+        }
     }
 }
 
@@ -1477,7 +1536,12 @@ bool SPDocument::_updateDocument(int update_flags, unsigned int object_modified_
 
             DocumentUndo::ScopedInsensitive _no_undo(this);
 
+            _updating = true;
             root->updateDisplay(&ctx, update_flags);
+            _updating = false;
+
+            // Bounds cached partway through the update may predate later steps of it.
+            geometry_epoch++;
         }
         _emitModified(object_modified_tag);
     }
@@ -1501,6 +1565,7 @@ gint SPDocument::ensureUpToDate(unsigned int object_modified_tag)
     //   1b) When completed, process connector routing changes.
     //   2a) Process any updates resulting from connector reroutings.
     int counter = 32;
+    bool rerouted = false;
     for (unsigned int pass = 1; pass <= 2; ++pass) {
         // Process document updates.
         while (!_updateDocument(0, object_modified_tag)) {
@@ -1518,14 +1583,30 @@ gint SPDocument::ensureUpToDate(unsigned int object_modified_tag)
         // After updates on the first pass we get libavoid to process all the
         // changed objects and provide new routings.  This may cause some objects
             // to be modified, hence the second update pass.
+        // Snapping and bounding box queries bring the document up to date on every motion event of
+        // a drag, so this is throttled like the idle rerouting: within the interval, the moves are
+        // left to the rerouting handler, which is scheduled below if requestModified() has not.
         if (pass == 1) {
-            _router->processTransaction();
+            auto const now = g_get_monotonic_time();
+            if (now - _last_rerouting >= SP_DOCUMENT_REROUTING_INTERVAL) {
+                if (_router->processTransaction()) {
+                    _last_rerouting = now;
+                }
+                rerouted = true;
+            }
         }
     }
 
     // Remove handlers
     modified_connection.disconnect();
-    rerouting_connection.disconnect();
+    if (rerouted) {
+        rerouting_connection.disconnect();
+    } else if (rerouting_connection.empty()) {
+        auto const wait = _last_rerouting + SP_DOCUMENT_REROUTING_INTERVAL - g_get_monotonic_time();
+        rerouting_connection =
+            Glib::signal_timeout().connect(sigc::mem_fun(*this, &SPDocument::rerouting_handler),
+                                           std::max<gint64>((wait + 999) / 1000, 0), SP_DOCUMENT_REROUTING_PRIORITY);
+    }
 
     return (counter > 0);
 }
@@ -1553,7 +1634,9 @@ SPDocument::rerouting_handler()
     // Process any queued movement actions and determine new routings for
     // object-avoiding connectors.  Callbacks will be used to update and
     // redraw affected connectors.
-    _router->processTransaction();
+    if (_router->processTransaction()) {
+        _last_rerouting = g_get_monotonic_time();
+    }
 
     // We don't need to handle rerouting again until there are further
     // diagram updates.
@@ -1926,6 +2009,10 @@ std::vector<SPObject *> const SPDocument::getResourceList(gchar const *key)
     g_return_val_if_fail(key != nullptr, emptyset);
     g_return_val_if_fail(*key != '\0', emptyset);
 
+    if (_deferred_build) {
+        _deferred_build->buildResources(key);
+    }
+
     return resources[key];
 }
 
@@ -1988,6 +2075,11 @@ static void vacuum_document_recursive(SPObject *obj)
  */
 unsigned int SPDocument::vacuumDocument()
 {
+    // Unused definitions may not have been built yet.
+    if (_deferred_build) {
+        _deferred_build->buildAll();
+    }
+
     unsigned int start = objects_in_document(this);
     unsigned int end;
     unsigned int newend = start;
@@ -2261,6 +2353,16 @@ sigc::connection SPDocument::connectBeforeCommit(SPDocument::BeforeCommitSignal:
     return before_commit_signal.connect(slot);
 }
 
+bool SPDocument::isIdObserved(char const *id) const
+{
+    auto const q = g_quark_try_string(id);
+    if (!q) {
+        return false;
+    }
+    auto it = id_changed_signals.find(q);
+    return it != id_changed_signals.end() && !it->second.empty();
+}
+
 sigc::connection SPDocument::connectIdChanged(gchar const *id,
                                               SPDocument::IDChangedSignal::slot_type slot)
 {
@@ -2338,6 +2440,16 @@ SPDocument::install_reference_document::~install_reference_document() {
     _parent->set_reference_document(nullptr);
 }
 
+SPDocument::lazy_build_scope::lazy_build_scope()
+    : _prev{lazy_build_requested}
+{
+    lazy_build_requested = true;
+}
+
+SPDocument::lazy_build_scope::~lazy_build_scope() {
+    lazy_build_requested = _prev;
+}
+
 bool SPDocument::get_origin_follows_page() {
     if (auto nv = getNamedView()) {
         return nv->get_origin_follows_page();
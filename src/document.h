@@ -19,12 +19,14 @@
  */
 
 #include <cstddef>                             // for size_t
+#include <cstdint>                             // for uint64_t
 #include <deque>                               // for deque
 #include <map>                                 // for map
 #include <memory>                              // for unique_ptr, default_de...
 #include <queue>                               // for queue
 #include <span>
 #include <string>                              // for string
+#include <unordered_map>                       // for unordered_map
 #include <vector>                              // for vector
 
 #include <boost/ptr_container/ptr_list.hpp>    // for ptr_list
@@ -77,6 +79,7 @@ class SPObject;
 class SPRoot;
 
 namespace Inkscape {
+    class DeferredBuild;
     class DocumentUndo;
     class Event;
     class EventLog;
@@ -104,6 +107,12 @@ public:
     /// For sanity check in SPObject::requestDisplayUpdate
     unsigned update_in_progress = 0;
 
+    /// Whether the object tree is being updated, unlike update_in_progress also in release builds
+    bool isUpdating() const { return _updating; }
+
+    /// Advanced whenever the geometry of any item may have changed, see SPItem::documentBounds
+    std::uint64_t geometry_epoch = 1;
+
     SPDocument();
     ~SPDocument();
     SPDocument(SPDocument const &) = delete;
@@ -303,6 +312,15 @@ public:
      */
     std::string generate_unique_id(char const *prefix);
 
+    /**
+     * @brief Generate a document-wide unique id from a base and a numeric suffix.
+     *
+     * Returns the id \a base followed by the first number greater than \a after that is not in use.
+     * The last number handed out is remembered for each base, so generating many ids from the same
+     * base takes amortized constant time rather than probing every earlier number again.
+     */
+    std::string generate_unique_id(std::string const &base, unsigned long after);
+
     /**
      * @brief Set the reference document object.
      * Use this function to extend functionality of getObjectById() - it will search in reference document.
@@ -324,6 +342,24 @@ public:
         SPDocument* _parent;
     };
 
+    /**
+     * @brief Object used to build documents lazily while it is alive.
+     * Top-level documents created on this thread leave hidden layers and unused resources in
+     * <defs> unbuilt until they are needed, see Inkscape::DeferredBuild.
+     */
+    struct lazy_build_scope {
+        lazy_build_scope();
+        ~lazy_build_scope();
+    private:
+        bool _prev;
+    };
+
+    /// The parts of the object tree that have not been built yet, or null if the document is built in full.
+    Inkscape::DeferredBuild *getDeferredBuild() const { return _deferred_build.get(); }
+
+    /// Whether anything is waiting for an object with the given id to appear.
+    bool isIdObserved(char const *id) const;
+
     std::vector<SPItem*> getItemsInBox         (unsigned int dkey, Geom::Rect const &box, bool take_hidden = false, bool take_insensitive = false, bool take_groups = true, bool enter_groups = false, bool enter_layers = true) const;
     std::vector<SPItem*> getItemsPartiallyInBox(unsigned int dkey, Geom::Rect const &box, bool take_hidden = false, bool take_insensitive = false, bool take_groups = true, bool enter_groups = false, bool enter_layers = true) const;
     SPItem *getItemAtPoint(unsigned int key, Geom::Point const &p, bool into_groups, SPItem *upto = nullptr) const;
@@ -385,6 +421,7 @@ private:
     bool modified_since_autosave = false;
     sigc::connection modified_connection;
     sigc::connection rerouting_connection;
+    gint64 _last_rerouting = 0; ///< Monotonic time of the last connector rerouting that changed anything
 
     // Document structure --------------------
     Inkscape::XML::Document *rdoc; ///< Our Inkscape::XML::Document
@@ -413,8 +450,11 @@ private:
     char *document_name;  ///< basename or other human-readable label for the document.
 
     // Find items ----------------------------
-    std::map<std::string, SPObject *> iddef;
+    std::unordered_map<std::string, SPObject *> iddef;
     std::map<Inkscape::XML::Node *, SPObject *> reprdef;
+    // Mutable because lookups such as getObjectById() build deferred objects on demand.
+    mutable std::unique_ptr<Inkscape::DeferredBuild> _deferred_build;
+    bool _updating = false;
 
     // Find items by geometry --------------------
     mutable std::map<unsigned long, std::deque<SPItem*>> _node_cache; // Used to speed up search.
@@ -442,6 +482,7 @@ private:
     unsigned long _serial; // Unique document number (used by undo/redo).
     Glib::ustring actionkey; // Last action key, used to combine actions in undo.
     unsigned long object_id_counter; // Steadily-incrementing counter used to assign unique ids to objects.
+    std::unordered_map<std::string, unsigned long> id_suffix_counters; // Last numeric suffix handed out per id base.
 
     // Garbage collecting ----------------------
 
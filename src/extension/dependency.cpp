@@ -11,6 +11,7 @@
 
 #include "dependency.h"
 
+#include <unordered_map>
 #include <glibmm/i18n.h>
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
@@ -23,6 +24,98 @@
 namespace Inkscape {
 namespace Extension {
 
+namespace {
+
+// Results of PATH searches while a Dependency::PathLookupScope exists, keyed by file test, type, name and PATH.
+int path_lookup_scopes = 0;
+std::unordered_map<std::string, std::string> path_lookups;
+
+/**
+    \brief   Search the PATH for a file
+    \return  The first match, or an empty string if there is none
+    \param   name       The name of the file to look for
+    \param   filetest   The test the file has to pass
+    \param   extension  The file extension of \a name, if any
+    \param   executable Whether an executable is looked for
+*/
+std::string find_in_path(std::string const &name, Glib::FileTest filetest, [[maybe_unused]] std::string const &extension, [[maybe_unused]] bool executable)
+{
+    // TODO: we can likely use g_find_program_in_path (or its glibmm equivalent) for executable types
+
+    gchar * path = g_strdup(g_getenv("PATH"));
+
+    if (path == nullptr) {
+        /* There is no `PATH' in the environment.
+           The default search path is the current directory */
+        path = g_strdup(G_SEARCHPATH_SEPARATOR_S);
+    }
+
+    gchar * orig_path = path;
+
+    for (; path != nullptr;) {
+        gchar * local_path; // to have the path after detection of the separator
+        std::string final_name;
+
+        local_path = path;
+        path = g_utf8_strchr(path, -1, G_SEARCHPATH_SEPARATOR);
+        /* Not sure whether this is UTF8 happy, but it would seem
+           like it considering that I'm searching (and finding)
+           the ':' character */
+        if (path != nullptr) {
+            path[0] = '\0';
+            path++;
+        }
+
+        if (*local_path == '\0') {
+            final_name = name;
+        } else {
+            final_name = Glib::build_filename(local_path, name);
+        }
+
+        if (Glib::file_test(final_name, filetest)) {
+            g_free(orig_path);
+            return final_name;
+        }
+
+#ifdef _WIN32
+        // Unfortunately file extensions tend to be different on Windows and we can't know
+        // which one it is, so try all extensions glib assumes to be executable.
+        // As we can only guess here, return the version without extension if either one is found,
+        // so that we don't accidentally override (or conflict with) some g_spawn_* magic.
+        if (executable) {
+            static const std::vector<std::string> extensions = {".exe", ".cmd", ".bat", ".com"};
+            if (extension.empty() ||
+                    std::find(extensions.begin(), extensions.end(), extension) == extensions.end())
+            {
+                for (auto extension : extensions) {
+                    if (Glib::file_test(final_name + extension, filetest)) {
+                        g_free(orig_path);
+                        return final_name;
+                    }
+                }
+            }
+        }
+#endif
+    }
+
+    g_free(orig_path);
+    return {};
+}
+
+} // namespace
+
+Dependency::PathLookupScope::PathLookupScope()
+{
+    path_lookup_scopes++;
+}
+
+Dependency::PathLookupScope::~PathLookupScope()
+{
+    if (--path_lookup_scopes == 0) {
+        path_lookups.clear();
+    }
+}
+
 // These strings are for XML attribute comparisons and should not be translated;
 // make sure to keep in sync with enum defined in dependency.h
 gchar const * Dependency::_type_str[] = {
@@ -226,68 +319,26 @@ bool Dependency::check ()
                 /* The default case is to look in the path */
                 case LOCATION_PATH:
                 default: {
-                    // TODO: we can likely use g_find_program_in_path (or its glibmm equivalent) for executable types
-
-                    gchar * path = g_strdup(g_getenv("PATH"));
-
-                    if (path == nullptr) {
-                        /* There is no `PATH' in the environment.
-                           The default search path is the current directory */
-                        path = g_strdup(G_SEARCHPATH_SEPARATOR_S);
-                    }
-
-                    gchar * orig_path = path;
-
-                    for (; path != nullptr;) {
-                        gchar * local_path; // to have the path after detection of the separator
-                        std::string final_name;
-
-                        local_path = path;
-                        path = g_utf8_strchr(path, -1, G_SEARCHPATH_SEPARATOR);
-                        /* Not sure whether this is UTF8 happy, but it would seem
-                           like it considering that I'm searching (and finding)
-                           the ':' character */
-                        if (path != nullptr) {
-                            path[0] = '\0';
-                            path++;
-                        }
-
-                        if (*local_path == '\0') {
-                            final_name = _string;
-                        } else {
-                            final_name = Glib::build_filename(local_path, _string);
-                        }
-
-                        if (Glib::file_test(final_name, filetest)) {
-                            g_free(orig_path);
-                            _absolute_location = final_name;
-                            return true;
+                    std::string found;
+                    if (path_lookup_scopes > 0) {
+                        // The file test alone does not tell executables from files on Windows,
+                        // where only executables are also probed with the usual suffixes.
+                        auto const key = std::to_string(static_cast<int>(filetest)) + (_type == TYPE_EXECUTABLE ? "x" : "f")
+                                       + '\n' + location + '\n' + Glib::getenv("PATH");
+                        auto [it, inserted] = path_lookups.try_emplace(key);
+                        if (inserted) {
+                            it->second = find_in_path(location, filetest, extension, _type == TYPE_EXECUTABLE);
                         }
-
-#ifdef _WIN32
-                        // Unfortunately file extensions tend to be different on Windows and we can't know
-                        // which one it is, so try all extensions glib assumes to be executable.
-                        // As we can only guess here, return the version without extension if either one is found,
-                        // so that we don't accidentally override (or conflict with) some g_spawn_* magic.
-                        if (_type == TYPE_EXECUTABLE) {
-                            static const std::vector<std::string> extensions = {".exe", ".cmd", ".bat", ".com"};
-                            if (extension.empty() ||
-                                    std::find(extensions.begin(), extensions.end(), extension) == extensions.end())
-                            {
-                                for (auto extension : extensions) {
-                                    if (Glib::file_test(final_name + extension, filetest)) {
-                                        g_free(orig_path);
-                                        _absolute_location = final_name;
-                                        return true;
-                                    }
-                                }
-                            }
-                        }
-#endif
+                        found = it->second;
+                    } else {
+                        found = find_in_path(location, filetest, extension, _type == TYPE_EXECUTABLE);
                     }
 
-                    g_free(orig_path);
-                    return false; /* Reverse logic in this one */
+                    if (found.empty()) {
+                        return false; /* Reverse logic in this one */
+                    }
+                    _absolute_location = found;
+                    break;
                 }
             } /* switch _location */
             break;
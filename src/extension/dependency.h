@@ -77,10 +77,24 @@ public:
     Dependency (Inkscape::XML::Node *in_repr, const Extension *extension, type_t type=TYPE_FILE);
     virtual ~Dependency ();
     bool check();
+    bool is_extension() const { return _type == TYPE_EXTENSION; }
     const gchar* get_name();
     std::string get_path();
 
     Glib::ustring info_string();
+
+    /** \brief  While one of these exists, the PATH is searched only once for each file that
+                dependencies ask for, and the result is shared between them.
+
+                Used while checking all extensions at once, when many of them ask for the same
+                executables and some are checked more than once. */
+    class PathLookupScope {
+    public:
+        PathLookupScope();
+        ~PathLookupScope();
+        PathLookupScope(PathLookupScope const &) = delete;
+        PathLookupScope &operator=(PathLookupScope const &) = delete;
+    };
 }; /* class Dependency */
 
 
@@ -363,6 +363,37 @@ Extension::deactivated ()
     return get_state() == STATE_DEACTIVATED;
 }
 
+/**
+    \return  Whether checking this extension involves other extensions
+    \brief   Find out if deactivating another extension could make this one fail its check
+
+    This is the case for explicit extension dependencies and for scripts
+    that call helper extensions.
+*/
+bool
+Extension::depends_on_extensions ()
+{
+    for (auto const &dep : _deps) {
+        if (dep->is_extension()) {
+            return true;
+        }
+    }
+
+    if (repr) {
+        for (auto child = repr->firstChild(); child; child = child->next()) {
+            if (!strcmp(child->name(), INKSCAPE_EXTENSION_NS "script")) {
+                for (auto helper = child->firstChild(); helper; helper = helper->next()) {
+                    if (!strcmp(helper->name(), INKSCAPE_EXTENSION_NS "helper_extension")) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
 /** Gets the location of the dependency file as an absolute path
   *
   * Iterates over all dependencies of this extension and finds the one with matching name,
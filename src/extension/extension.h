@@ -186,6 +186,7 @@ public:
     char const   *get_name     () const;
     virtual void  deactivate   ();
     bool          deactivated  ();
+    bool          depends_on_extensions();
     void          printFailure (Glib::ustring const &reason);
     std::string const &getErrorReason() { return _error_reason; };
     Implementation::Implementation *get_imp() { return imp.get(); }
@@ -20,11 +20,13 @@
 #include <algorithm>
 #include <iterator>
 #include <utility>
+#include <vector>
 #include <glibmm/fileutils.h>
 #include <glibmm/i18n.h>
 #include <glibmm/ustring.h>
 
 #include "db.h"
+#include "dependency.h"
 #include "internal/emf-inout.h"
 #include "internal/emf-print.h"
 #include "internal/svgz.h"
@@ -323,25 +325,38 @@ refresh_user_extensions()
 
 
 static void
-check_extensions_internal(Extension *in_plug, gpointer in_data)
+collect_active_extensions(Extension *in_plug, gpointer in_data)
 {
-    int *count = (int *)in_data;
+    auto extensions = static_cast<std::vector<Extension *> *>(in_data);
 
-    if (in_plug == nullptr) return;
-    if (!in_plug->deactivated() && !in_plug->check()) {
-         in_plug->deactivate();
-        (*count)++;
+    if (in_plug && !in_plug->deactivated()) {
+        extensions->push_back(in_plug);
     }
 }
 
 static void check_extensions()
 {
-    int count = 1;
+    std::vector<Extension *> pending;
+    db.foreach(collect_active_extensions, &pending);
+
+    // Many extensions ask for the same executables in the PATH; look each of them up once.
+    auto path_lookups = Dependency::PathLookupScope();
 
     Inkscape::Extension::Extension::error_file_open();
-    while (count != 0) {
-        count = 0;
-        db.foreach(check_extensions_internal, (gpointer)&count);
+    while (!pending.empty()) {
+        bool changed = false;
+        for (auto ext : pending) {
+            if (!ext->deactivated() && !ext->check()) {
+                ext->deactivate();
+                changed = true;
+            }
+        }
+        if (!changed) {
+            break;
+        }
+        // A deactivation can only break extensions that rely on other extensions, so only those
+        // are checked again rather than repeating every file and PATH lookup.
+        std::erase_if(pending, [] (Extension *ext) { return ext->deactivated() || !ext->depends_on_extensions(); });
     }
     Inkscape::Extension::Extension::error_file_close();
 }
@@ -1626,6 +1626,11 @@ bool CairoRenderContext::renderImage(Inkscape::Pixbuf const *pb,
         return false;
     }
 
+    if (_vector_based_target) {
+        // Let the PDF/PS surface embed identical images only once
+        pb->ensureUniqueId();
+    }
+
     cairo_save(_cr);
 
     // scaling by width & height is not needed because it will be done by Cairo
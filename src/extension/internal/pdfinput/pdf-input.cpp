@@ -60,6 +60,7 @@
 #include "inkscape.h"
 #include "object/sp-root.h"
 #include "pdf-parser.h"
+#include "poppler-utils.h"
 #include "preferences.h"
 #include "ui/builder-utils.h"
 #include "ui/dialog-events.h"
@@ -686,6 +687,17 @@ std::unique_ptr<SPDocument> PdfInput::open(Inkscape::Extension::Input *, char co
         if (dlg)
             dlg->getImportSettings(prefs);
 
+        // Document metadata is shared by all pages, so it is only set once
+        if (auto meta = pdf_doc->readMetadata()) {
+            // TODO: Parse this metadat RDF document and extract SVG RDF details from it.
+            // meta->getCString()
+        }
+        builder->setMetadata("title", getString(pdf_doc->getDocInfoStringEntry("Title")));
+        builder->setMetadata("description", getString(pdf_doc->getDocInfoStringEntry("Subject")));
+        builder->setMetadata("creator", getString(pdf_doc->getDocInfoStringEntry("Author")));
+        builder->setMetadata("subject", getString(pdf_doc->getDocInfoStringEntry("Keywords")));
+        builder->setMetadata("date", getString(pdf_doc->getDocInfoStringEntry("CreationDate")));
+
         for (auto p : pages) {
             // And then add each of the pages
             add_builder_page(pdf_doc, builder, doc.get(), p);
@@ -77,6 +77,7 @@ SvgBuilder::SvgBuilder(SPDocument *document, gchar *docname, XRef *xref)
     _xref = xref;
     _xml_doc = _doc->getReprDoc();
     _container = _root = _doc->getReprRoot();
+    _resources = std::make_shared<SvgBuilderResources>();
     _init();
 
     // Set default preference settings
@@ -91,6 +92,7 @@ SvgBuilder::SvgBuilder(SvgBuilder *parent, Inkscape::XML::Node *root) {
     _xref = parent->_xref;
     _xml_doc = parent->_xml_doc;
     _preferences = parent->_preferences;
+    _resources = parent->_resources;
     _container = this->_root = root;
     _init();
 }
@@ -839,8 +841,41 @@ bool SvgBuilder::_shouldClip(const Inkscape::XML::Node *node) const
     // Calculate bounding boxes for both the node and the clip path
     Geom::PathVector node_vec = sp_svg_read_pathv(node->attribute("d"));
 
+    // Images are placed by their transform, so their box is known without updating the
+    // document. This avoids a document-wide update for every image on pages with many.
+    auto const image_box = [] (Inkscape::XML::Node const *image) -> Geom::OptRect {
+        auto const x = image->getAttributeDouble("x", 0.0);
+        auto const y = image->getAttributeDouble("y", 0.0);
+        auto const w = image->getAttributeDouble("width", 0.0);
+        auto const h = image->getAttributeDouble("height", 0.0);
+        if (w > 0 && h > 0) {
+            return Geom::Rect::from_xywh(x, y, w, h);
+        }
+        return {};
+    };
+
+    if (node_vec.empty() && !g_strcmp0(node->name(), "svg:image")) {
+        if (auto box = image_box(node)) {
+            node_vec.push_back(Geom::Path(*box));
+        }
+    } else if (node_vec.empty() && !g_strcmp0(node->name(), "svg:use")) {
+        // A repeated image, see _reuseImage(): the box of the shared image, offset by the clone.
+        auto const href = node->attribute("xlink:href");
+        auto const ref = href && href[0] == '#' ? _doc->getObjectById(href + 1) : nullptr;
+        if (ref && !g_strcmp0(ref->getRepr()->name(), "svg:image")) {
+            if (auto box = image_box(ref->getRepr())) {
+                Geom::Affine image_tr = Geom::identity();
+                if (auto attr = ref->getRepr()->attribute("transform")) {
+                    sp_svg_transform_read(attr, &image_tr);
+                }
+                auto const offset = Geom::Translate(node->getAttributeDouble("x", 0.0), node->getAttributeDouble("y", 0.0));
+                node_vec.push_back(Geom::Path(*box) * (image_tr * offset));
+            }
+        }
+    }
+
     if (node_vec.empty()) {
-        // Non-path node (text, image, etc)
+        // Non-path node (text, etc)
         // Create a PathVector of the bounding box instead
         _doc->ensureUpToDate();
         auto item = cast<SPItem>(_doc->getObjectByRepr(const_cast<Inkscape::XML::Node *>(node)));
@@ -1123,8 +1158,15 @@ gchar *SvgBuilder::_createTilingPattern(GfxTilingPattern *tiling_pattern,
     delete pdf_parser;
     delete pattern_builder;
 
+    // Reuse an identical pattern if this one was drawn before
+    if (gchar *id = _reuseDef(pattern_node)) {
+        Inkscape::GC::release(pattern_node);
+        return id;
+    }
+
     // Append the pattern to defs
     _doc->getDefs()->getRepr()->appendChild(pattern_node);
+    _registerDef(pattern_node);
     gchar *id = g_strdup(pattern_node->attribute("id"));
     Inkscape::GC::release(pattern_node);
 
@@ -1191,7 +1233,13 @@ gchar *SvgBuilder::_createGradient(GfxShading *shading, const Geom::Affine pat_m
         return nullptr;
     }
 
+    if (gchar *id = _reuseDef(gradient)) {
+        Inkscape::GC::release(gradient);
+        return id;
+    }
+
     _doc->getDefs()->getRepr()->appendChild(gradient);
+    _registerDef(gradient);
     gchar *id = g_strdup(gradient->attribute("id"));
     Inkscape::GC::release(gradient);
 
@@ -2196,6 +2244,7 @@ Inkscape::XML::Node *SvgBuilder::_createImage(Stream *str, int width, int height
         auto png_data = std::string("data:image/png;base64,") + base64String;
         g_free(base64String);
         image_node->setAttributeOrRemoveIfEmpty("xlink:href", png_data);
+        return _reuseImage(image_node);
     } else {
         fclose(fp);
         image_node->setAttribute("xlink:href", file_name);
@@ -2205,6 +2254,159 @@ Inkscape::XML::Node *SvgBuilder::_createImage(Stream *str, int width, int height
     return image_node;
 }
 
+SvgBuilderResources::~SvgBuilderResources()
+{
+    for (auto &[key, node] : images) {
+        Inkscape::GC::release(node);
+    }
+}
+
+static void append_content_key(Inkscape::XML::Node const *node, std::string &key)
+{
+    static GQuark const id_key = g_quark_from_static_string("id");
+
+    if (node->type() == Inkscape::XML::NodeType::TEXT_NODE) {
+        if (auto content = node->content()) {
+            key += content;
+        }
+        return;
+    }
+    key += node->name();
+    key += '[';
+    for (auto const &attr : node->attributeList()) {
+        if (attr.key != id_key) {
+            key += g_quark_to_string(attr.key);
+            key += '=';
+            key += attr.value.pointer();
+            key += ';';
+        }
+    }
+    for (auto child = node->firstChild(); child; child = child->next()) {
+        append_content_key(child, key);
+    }
+    key += ']';
+}
+
+/**
+ * Hash a node's name, attributes and children, ignoring ids, so that resources the PDF
+ * draws repeatedly (from XObjects referenced on every page) can be recognised.
+ */
+std::string SvgBuilder::_contentKey(Inkscape::XML::Node const *node)
+{
+    std::string key;
+    append_content_key(node, key);
+    gchar *hash = g_compute_checksum_for_string(G_CHECKSUM_SHA256, key.c_str(), key.size());
+    std::string result = hash;
+    g_free(hash);
+    return result;
+}
+
+/**
+ * Return an identical gradient or pattern already in <defs>, or nullptr if there is none.
+ * \return a newly allocated copy of the id of the existing definition
+ */
+gchar *SvgBuilder::_reuseDef(Inkscape::XML::Node *def_node)
+{
+    auto it = _resources->defs.find(_contentKey(def_node));
+    if (it == _resources->defs.end() || !_doc->getObjectById(it->second)) {
+        return nullptr;
+    }
+    _resources->shared.insert(it->second);
+    return g_strdup(it->second.c_str());
+}
+
+/**
+ * Remember a gradient or pattern appended to <defs> so later identical ones can reuse it.
+ */
+void SvgBuilder::_registerDef(Inkscape::XML::Node *def_node)
+{
+    if (auto id = def_node->attribute("id")) {
+        auto const key = _contentKey(def_node);
+        if (_resources->defs.emplace(key, id).second) {
+            _resources->def_keys.emplace(id, key);
+        }
+    }
+}
+
+/**
+ * Forget a definition that is about to be edited or removed, so it is no longer handed out
+ * for content it does not have any more.
+ */
+void SvgBuilder::_unregisterDef(Inkscape::XML::Node const *def_node)
+{
+    auto id = def_node->attribute("id");
+    if (!id) {
+        return;
+    }
+    if (auto it = _resources->def_keys.find(id); it != _resources->def_keys.end()) {
+        _resources->defs.erase(it->second);
+        _resources->def_keys.erase(it);
+    }
+}
+
+/**
+ * Whether a definition is referenced by more than one object and so must not be edited in place.
+ */
+bool SvgBuilder::_isShared(Inkscape::XML::Node const *def_node) const
+{
+    auto id = def_node->attribute("id");
+    return id && _resources->shared.count(id);
+}
+
+/**
+ * Return a clone of an identical, previously created image instead of image_node if there is one.
+ *
+ * The first occurrence of a bitmap stays a plain <image>. When the same bitmap is drawn again,
+ * that image is moved into <defs> and replaced by a <use>, so every distinct bitmap is embedded
+ * only once no matter how often the PDF draws it.
+ */
+Inkscape::XML::Node *SvgBuilder::_reuseImage(Inkscape::XML::Node *image_node)
+{
+    auto const key = _contentKey(image_node);
+    auto it = _resources->images.find(key);
+    if (it == _resources->images.end()) {
+        _resources->images.emplace(key, Inkscape::GC::anchor(image_node));
+        return image_node;
+    }
+
+    auto defs = _doc->getDefs()->getRepr();
+    auto source = it->second;
+    if (source->parent() != defs) {
+        auto parent = source->parent();
+        if (!parent) {
+            // The first occurrence was never placed, this one takes over.
+            Inkscape::GC::release(source);
+            it->second = Inkscape::GC::anchor(image_node);
+            return image_node;
+        }
+
+        // Move the bitmap itself into defs and leave a clone with the placement behind.
+        auto shared_image = image_node->duplicate(_xml_doc);
+        defs->appendChild(shared_image);
+
+        auto clone = _xml_doc->createElement("svg:use");
+        clone->setAttribute("xlink:href", std::string("#") + shared_image->attribute("id"));
+        for (auto const &attr : source->attributeList()) {
+            auto const name = g_quark_to_string(attr.key);
+            if (g_strcmp0(name, "id") && (!image_node->attribute(name) || !g_strcmp0(name, "style"))) {
+                clone->setAttribute(name, attr.value.pointer());
+            }
+        }
+        parent->addChild(clone, source);
+        parent->removeChild(source);
+        Inkscape::GC::release(clone);
+
+        Inkscape::GC::release(source);
+        it->second = Inkscape::GC::anchor(shared_image);
+        Inkscape::GC::release(shared_image);
+    }
+
+    Inkscape::GC::release(image_node);
+    auto clone = _xml_doc->createElement("svg:use");
+    clone->setAttribute("xlink:href", std::string("#") + it->second->attribute("id"));
+    return clone;
+}
+
 /**
  * \brief Creates a <mask> with the specified width and height and adds to <defs>
  *  If we're not the top-level SvgBuilder, creates a <defs> too and adds the mask to it.
@@ -2372,8 +2574,9 @@ void SvgBuilder::applyOptionalMask(Inkscape::XML::Node *mask, Inkscape::XML::Nod
         auto source = mask->firstChild();
         auto source_gr = _getGradientNode(source, true);
         auto target_gr = _getGradientNode(target, true);
-        // Both objects have a gradient, try and merge them
-        if (source_gr && target_gr && source_gr->childCount() == target_gr->childCount()) {
+        // Both objects have a gradient, try and merge them, unless other objects use them too
+        if (source_gr && target_gr && source_gr->childCount() == target_gr->childCount() &&
+            !_isShared(source_gr) && !_isShared(target_gr)) {
             bool same_pos = _attrEqual(source_gr, target_gr, "x1") && _attrEqual(source_gr, target_gr, "x2")
                          && _attrEqual(source_gr, target_gr, "y1") && _attrEqual(source_gr, target_gr, "y2");
 
@@ -2388,6 +2591,10 @@ void SvgBuilder::applyOptionalMask(Inkscape::XML::Node *mask, Inkscape::XML::Nod
             }
 
             if (same_pos && white_mask) {
+                // The target's stops change, so it must not be reused for its old content.
+                _unregisterDef(target_gr);
+                _unregisterDef(source_gr);
+
                 // We move the stop-opacity from the source to the target
                 auto target_st = target_gr->firstChild();
                 for (auto source_st = source_gr->firstChild(); source_st != nullptr; source_st = source_st->next()) {
@@ -2397,6 +2604,7 @@ void SvgBuilder::applyOptionalMask(Inkscape::XML::Node *mask, Inkscape::XML::Nod
                     sp_repr_css_change(target_st, target_css, "style");
                     target_st = target_st->next();
                 }
+                _registerDef(target_gr);
                 // Remove mask and gradient xml objects
                 mask->parent()->removeChild(mask);
                 source_gr->parent()->removeChild(source_gr);
@@ -61,6 +61,8 @@ class ClipHistoryEntry;
 #include <glib.h>
 #include <map>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace Inkscape {
@@ -95,6 +97,20 @@ struct SvgGlyph {
     std::shared_ptr<CairoFont> cairo_font; // A pointer to the selected cairo font
 };
 
+/**
+ * Definitions shared between an SvgBuilder and the sub-builders it creates for patterns and
+ * masks, keyed by a hash of their content so repeated resources are only written once.
+ */
+struct SvgBuilderResources
+{
+    ~SvgBuilderResources();
+
+    std::unordered_map<std::string, Inkscape::XML::Node *> images; // Anchored first occurrences
+    std::unordered_map<std::string, std::string> defs;              // Gradients and patterns by id
+    std::unordered_map<std::string, std::string> def_keys;          // Content keys of defs by id
+    std::unordered_set<std::string> shared;                         // Ids referenced more than once
+};
+
 /**
  * Builds the inner SVG representation using libpoppler from the calls of PdfParser.
  */
@@ -203,6 +219,14 @@ private:
     Inkscape::XML::Node *_createMask(double width, double height);
     Inkscape::XML::Node *_createClip(const std::string &d, const Geom::Affine tr, bool even_odd);
 
+    // Resource sharing
+    static std::string _contentKey(Inkscape::XML::Node const *node);
+    Inkscape::XML::Node *_reuseImage(Inkscape::XML::Node *image_node);
+    gchar *_reuseDef(Inkscape::XML::Node *def_node);
+    void _registerDef(Inkscape::XML::Node *def_node);
+    void _unregisterDef(Inkscape::XML::Node const *def_node);
+    bool _isShared(Inkscape::XML::Node const *def_node) const;
+
     // Style setting
     SPCSSAttr *_setStyle(GfxState *state, bool fill, bool stroke, bool even_odd=false);
     void _setStrokeStyle(SPCSSAttr *css, GfxState *state);
@@ -293,6 +317,8 @@ private:
     
     // Keep track of the previously created clip path
     Inkscape::XML::Node *_prev_clip = nullptr;
+
+    std::shared_ptr<SvgBuilderResources> _resources;
 };
 
 
@@ -14,6 +14,7 @@
 
 #include "id-clash.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <list>
@@ -21,8 +22,6 @@
 #include <string>
 #include <utility>
 
-#include <glibmm/regex.h>
-
 #include "attributes.h"                              // for SPAttr
 #include "document.h"                                // for SPDocument
 #include "extract-uri.h"                             // for extract_uri
@@ -411,13 +410,10 @@ static void change_clashing_ids(SPDocument *imported_doc, SPDocument *current_do
 
         if (fix_clashing_ids) {
             std::string old_id(id);
-            std::string new_id(old_id + '-');
-            for (;;) {
-                new_id += "0123456789"[std::rand() % 10];
-                const char *str = new_id.c_str();
-                if (current_doc->getObjectById(str) == nullptr &&
-                    imported_doc->getObjectById(str) == nullptr) break;
-            }
+            std::string new_id;
+            do {
+                new_id = current_doc->generate_unique_id(old_id + '-', 0);
+            } while (imported_doc->getObjectById(new_id));
             // Change to the new ID
 
             elem->setAttribute("id", new_id);
@@ -524,6 +520,26 @@ Glib::ustring sanitize_id(const Glib::ustring& input_id) {
     return id;
 }
 
+/**
+ * If 'id' ends with "-<number>", split it into the part before the number and the number.
+ * Only numbers with up to 9 digits are accepted; further digits are left out of the number.
+ */
+static bool split_numeric_suffix(std::string const &id, std::string &base, unsigned long &counter)
+{
+    for (auto pos = id.rfind('-'); pos != std::string::npos; pos = pos > 0 ? id.rfind('-', pos - 1) : std::string::npos) {
+        auto end = id.find_first_not_of("0123456789", pos + 1);
+        if (end == std::string::npos) {
+            end = id.size();
+        }
+        if (end > pos + 1) {
+            base = id.substr(0, pos);
+            counter = std::stoul(id.substr(pos + 1, std::min<std::size_t>(9, end - pos - 1)));
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * Modify 'base_name' to create a new ID that is not used in the 'document'
 */
@@ -544,21 +560,10 @@ Glib::ustring generate_similar_unique_id(SPDocument* document, const Glib::ustri
     if (document && document->getObjectById(id.c_str())) {
         // conflict; check if id ends with "-<number>", so we can increase it;
         // only accept numbers with up to 9 digits and ignore other/larger digit strings
-        Glib::RefPtr<Glib::Regex> regex = Glib::Regex::create("(.*)-(\\d{1,9})");
-        Glib::MatchInfo info;
-        regex->match(id, info);
         unsigned long counter = 0;
-        auto base = id;
-        if (info.matches()) {
-            base = info.fetch(1);
-            counter = std::stoul(info.fetch(2));
-        }
-        base += '-';
-        for (;;) {
-            counter++;
-            id = base + std::to_string(counter);
-            if (document->getObjectById(id.c_str()) == nullptr) break;
-        }
+        std::string base = id.raw();
+        split_numeric_suffix(id.raw(), base, counter);
+        id = document->generate_unique_id(base + '-', counter);
     }
 
     return id;
@@ -593,12 +598,7 @@ void rename_id(SPObject *elem, Glib::ustring const &new_name)
         // To try to preserve any meaningfulness that the original ID
         // may have had, the new ID is the old ID followed by a hyphen
         // and one or more digits.
-        new_name2 += '-';
-        for (;;) {
-            new_name2 += "0123456789"[std::rand() % 10];
-            if (current_doc->getObjectById(new_name2) == nullptr)
-                break;
-        }
+        new_name2 = current_doc->generate_unique_id(new_name2.raw() + '-', 0);
     }
     g_free (id);
     // Change to the new ID
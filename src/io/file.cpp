@@ -12,6 +12,7 @@
 
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <unistd.h>
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
@@ -25,7 +26,9 @@
 #include "extension/output.h"
 #include "extension/input.h"
 #include "object/sp-root.h"
+#include "preferences.h"
 #include "xml/repr.h"
+#include "xml/repr-cache.h"
 
 /**
  * Create a blank document, remove any template data.
@@ -90,6 +93,14 @@ std::pair<std::unique_ptr<SPDocument>, bool> ink_file_open(Glib::RefPtr<Gio::Fil
     std::unique_ptr<SPDocument> doc;
     std::string path = file->get_path();
 
+    std::optional<SPDocument::lazy_build_scope> lazy;
+    if (Inkscape::Preferences::get()->getBool("/options/lazybuild/enabled", false)) {
+        lazy.emplace();
+    }
+
+    // Only the file the user asked for may come from the document cache.
+    auto cache_scope = Inkscape::XML::DocumentCache::Scope(path);
+
     // TODO: It's useless to catch these exceptions here (and below) unless we do something with them.
     //       If we can't properly handle them (e.g. by showing a user-visible message) don't catch them!
     try {
@@ -41,7 +41,10 @@ Inkscape::ObjectSnapper::ObjectSnapper(SnapManager *sm, Geom::Coord const d)
     : Snapper(sm, d)
 {
     _points_to_snap_to = std::make_unique<std::vector<SnapCandidatePoint>>();
+    _points_index = std::make_unique<SnapCandidatePointIndex>();
     _paths_to_snap_to = std::make_unique<std::vector<SnapCandidatePath>>();
+    _paths_index = std::make_unique<SnapCandidatePathIndex>();
+    _crossings_cache = std::make_unique<CurveCrossingsCache>();
 }
 
 Inkscape::ObjectSnapper::~ObjectSnapper()
@@ -70,6 +73,7 @@ void Inkscape::ObjectSnapper::_collectNodes(SnapSourceType const &t,
     // first point and store the collection for later use. This significantly improves the performance
     if (first_point) {
         _points_to_snap_to->clear();
+        _points_index->clear();
 
          // Determine the type of bounding box we should snap to
         SPItem::BBoxType bbox_type = SPItem::GEOMETRIC_BBOX;
@@ -200,9 +204,11 @@ void Inkscape::ObjectSnapper::_snapNodes(IntermSnapResults &isr,
 {
     // Iterate through all nodes, find out which one is the closest to p, and snap to it!
 
-    _collectNodes(p.getSourceType(), p.getSourceNum() <= 0);
+    bool const first_point = p.getSourceNum() <= 0;
+    _collectNodes(p.getSourceType(), first_point);
 
-    if (unselected_nodes != nullptr && unselected_nodes->size() > 0) {
+    // The unselected nodes don't change during a drag, so only add them along with the other nodes
+    if (first_point && unselected_nodes != nullptr && unselected_nodes->size() > 0) {
         g_assert(_points_to_snap_to != nullptr);
         _points_to_snap_to->insert(_points_to_snap_to->end(), unselected_nodes->begin(), unselected_nodes->end());
     }
@@ -210,8 +216,9 @@ void Inkscape::ObjectSnapper::_snapNodes(IntermSnapResults &isr,
     SnappedPoint s;
     bool success = false;
     bool strict_snapping = _snapmanager->snapprefs.getStrictSnapping();
+    Geom::Coord const tol = getSnapperTolerance();
 
-    for (const auto & k : *_points_to_snap_to) {
+    auto try_node = [&] (SnapCandidatePoint const &k) {
         if (_allowSourceToSnapToTarget(p.getSourceType(), k.getTargetType(), strict_snapping)) {
             Geom::Point target_pt = k.getPoint();
             Geom::Coord dist = Geom::L2(target_pt - p.getPoint()); // Default: free (unconstrained) snapping
@@ -221,17 +228,33 @@ void Inkscape::ObjectSnapper::_snapNodes(IntermSnapResults &isr,
                 if (Geom::L2(target_pt - c.projection(target_pt)) > 1e-9) {
                     // The distance from the target point to its projection on the constraint
                     // is too large, so this point is not on the constraint. Skip it!
-                    continue;
+                    return;
                 }
                 dist = Geom::L2(target_pt - p_proj_on_constraint);
             }
 
-            if (dist < getSnapperTolerance() && dist < s.getSnapDistance()) {
+            if (dist < tol && dist < s.getSnapDistance()) {
                 bool always = getSnapperAlwaysSnap(p.getSourceType());
-                s = SnappedPoint(target_pt, p.getSourceType(), p.getSourceNum(), k.getTargetType(), dist, getSnapperTolerance(), always, false, true, k.getTargetBBox());
+                s = SnappedPoint(target_pt, p.getSourceType(), p.getSourceNum(), k.getTargetType(), dist, tol, always, false, true, k.getTargetBBox());
                 success = true;
             }
         }
+    };
+
+    if (first_point) {
+        // A single point (or the first of many) is cheaper to snap by just scanning all nodes
+        for (const auto & k : *_points_to_snap_to) {
+            try_node(k);
+        }
+    } else {
+        // Further points of the same snap only look at the nodes within the tolerance
+        if (!_points_index->built()) {
+            _points_index->build(*_points_to_snap_to);
+        }
+        auto const center = c.isUndefined() ? p.getPoint() : p_proj_on_constraint;
+        for (auto i : _points_index->query(Geom::Rect(center - Geom::Point(tol, tol), center + Geom::Point(tol, tol)))) {
+            try_node((*_points_to_snap_to)[i]);
+        }
     }
 
     if (success) {
@@ -281,6 +304,13 @@ void Inkscape::ObjectSnapper::_collectPaths(Geom::Point /*p*/,
     if (first_point) {
         _clear_paths();
 
+        // The crossings cache is keyed on curve geometry, so it stays valid while the paths are
+        // collected again. Only a switch to another document makes all of it useless.
+        if (_crossings_document != _snapmanager->getDocument()) {
+            _crossings_cache->clear();
+            _crossings_document = _snapmanager->getDocument();
+        }
+
         // Determine the type of bounding box we should snap to
         SPItem::BBoxType bbox_type = SPItem::GEOMETRIC_BBOX;
 
@@ -425,79 +455,88 @@ void Inkscape::ObjectSnapper::_snapPaths(IntermSnapResults &isr,
         }
     }
 
-    int num_path = 0; // _paths_to_snap_to contains multiple path_vectors, each containing multiple paths.
-                      // num_path will count the paths, and will not be zeroed for each path_vector. It will
-                      // continue counting
-
     bool strict_snapping = _snapmanager->snapprefs.getStrictSnapping();
     bool snap_perp = _snapmanager->snapprefs.isTargetSnappable(Inkscape::SNAPTARGET_PATH_PERPENDICULAR);
     bool snap_tang = _snapmanager->snapprefs.isTargetSnappable(Inkscape::SNAPTARGET_PATH_TANGENTIAL);
 
-    //dt->getSnapIndicator()->remove_debugging_points();
-    for (const auto & it_p : *_paths_to_snap_to) {
+    // _paths_to_snap_to contains multiple path_vectors, each containing multiple paths. These paths are numbered
+    // consecutively across the path_vectors that this source may snap to; find where each path_vector starts.
+    std::vector<int> first_num_path(_paths_to_snap_to->size());
+    for (int i = 0, num_path = 0; i < _paths_to_snap_to->size(); i++) {
+        first_num_path[i] = num_path;
+        auto const &it_p = (*_paths_to_snap_to)[i];
         if (_allowSourceToSnapToTarget(p.getSourceType(), it_p.target_type, strict_snapping)) {
-            bool const being_edited = node_tool_active && it_p.currently_being_edited;
-            //if true then this pathvector it_pv is currently being edited in the node tool
-
-            for (auto &it_pv : it_p.path_vector) {
-                // Find a nearest point for each curve within this path
-                // n curves will return n time values with 0 <= t <= 1
-                std::vector<double> anp = it_pv.nearestTimePerCurve(p_doc);
-
-                //std::cout << "#nearest points = " << anp.size() << " | p = " << p.getPoint() << std::endl;
-                // Now we will examine each of the nearest points, and determine whether it's within snapping range and if we should snap to it
-                std::vector<double>::const_iterator np = anp.begin();
-                unsigned int index = 0;
-                for (; np != anp.end(); ++np, index++) {
-                    Geom::Curve const *curve = &it_pv.at(index);
-                    Geom::Point const sp_doc = curve->pointAt(*np);
-                    //dt->getSnapIndicator()->set_new_debugging_point(sp_doc*dt->doc2dt());
-                    bool c1 = true;
-                    bool c2 = true;
-                    if (being_edited) {
-                        /* If the path is being edited, then we should only snap though to stationary pieces of the path
-                         * and not to the pieces that are being dragged around. This way we avoid
-                         * self-snapping. For this we check whether the nodes at both ends of the current
-                         * piece are unselected; if they are then this piece must be stationary
-                         */
-                        g_assert(unselected_nodes != nullptr);
-                        Geom::Point start_pt = dt->doc2dt(curve->pointAt(0));
-                        Geom::Point end_pt = dt->doc2dt(curve->pointAt(1));
-                        c1 = isUnselectedNode(start_pt, unselected_nodes);
-                        c2 = isUnselectedNode(end_pt, unselected_nodes);
-                        /* Unfortunately, this might yield false positives for coincident nodes. Inkscape might therefore mistakenly
-                         * snap to path segments that are not stationary. There are at least two possible ways to overcome this:
-                         * - Linking the individual nodes of the SPPath we have here, to the nodes of the NodePath::SubPath class as being
-                         *   used in sp_nodepath_selected_nodes_move. This class has a member variable called "selected". For this the nodes
-                         *   should be in the exact same order for both classes, so we can index them
-                         * - Replacing the SPPath being used here by the NodePath::SubPath class; but how?
-                         */
-                    }
+            num_path += it_p.path_vector.size();
+        }
+    }
 
-                    Geom::Point const sp_dt = dt->doc2dt(sp_doc);
-                    if (!being_edited || (c1 && c2)) {
-                        Geom::Coord dist = Geom::distance(sp_doc, p_doc);
-                        // std::cout << "  dist -> " << dist << std::endl;
-                        if (dist < getSnapperTolerance()) {
-                            // Add the curve we have snapped to
-                            Geom::Point sp_tangent_dt = Geom::Point(0,0);
-                            if (p.getSourceType() == Inkscape::SNAPSOURCE_GUIDE_ORIGIN) {
-                                // We currently only use the tangent when snapping guides, so only in this case we will
-                                // actually calculate the tangent to avoid wasting CPU cycles
-                                Geom::Point sp_tangent_doc = curve->unitTangentAt(*np);
-                                sp_tangent_dt = dt->doc2dt(sp_tangent_doc) - dt->doc2dt(Geom::Point(0,0));
-                            }
-                            bool always = getSnapperAlwaysSnap(p.getSourceType());
-                            isr.curves.emplace_back(sp_dt, sp_tangent_dt, num_path, index, dist, getSnapperTolerance(), always, false, curve, p.getSourceType(), p.getSourceNum(), it_p.target_type, it_p.target_bbox);
-                            if (snap_tang || snap_perp) {
-                                // For each curve that's within snapping range, we will now also search for tangential and perpendicular snaps
-                                _snapPathsTangPerp(snap_tang, snap_perp, isr, p, curve, dt);
-                            }
-                        }
-                    }
+    if (!_paths_index->built()) {
+        _paths_index->build(*_paths_to_snap_to);
+    }
+
+    Geom::Coord const tolerance = getSnapperTolerance();
+
+    //dt->getSnapIndicator()->remove_debugging_points();
+    // The nearest point on a curve lies within its bounds, so only the curves with bounds within range can be snapped to
+    for (auto const &segment : _paths_index->query(p_doc, tolerance)) {
+        auto const &it_p = (*_paths_to_snap_to)[segment.path];
+        if (!_allowSourceToSnapToTarget(p.getSourceType(), it_p.target_type, strict_snapping)) {
+            continue;
+        }
+
+        bool const being_edited = node_tool_active && it_p.currently_being_edited;
+        //if true then this pathvector it_pv is currently being edited in the node tool
+
+        int const num_path = first_num_path[segment.path] + segment.subpath;
+        unsigned int const index = segment.curve;
+        Geom::Curve const *curve = &it_p.path_vector[segment.subpath].at(index);
+
+        // Find the nearest point on this curve, with 0 <= t <= 1
+        Geom::Coord const np = curve->nearestTime(p_doc);
+        Geom::Point const sp_doc = curve->pointAt(np);
+        //dt->getSnapIndicator()->set_new_debugging_point(sp_doc*dt->doc2dt());
+        bool c1 = true;
+        bool c2 = true;
+        if (being_edited) {
+            /* If the path is being edited, then we should only snap though to stationary pieces of the path
+             * and not to the pieces that are being dragged around. This way we avoid
+             * self-snapping. For this we check whether the nodes at both ends of the current
+             * piece are unselected; if they are then this piece must be stationary
+             */
+            g_assert(unselected_nodes != nullptr);
+            Geom::Point start_pt = dt->doc2dt(curve->pointAt(0));
+            Geom::Point end_pt = dt->doc2dt(curve->pointAt(1));
+            c1 = isUnselectedNode(start_pt, unselected_nodes);
+            c2 = isUnselectedNode(end_pt, unselected_nodes);
+            /* Unfortunately, this might yield false positives for coincident nodes. Inkscape might therefore mistakenly
+             * snap to path segments that are not stationary. There are at least two possible ways to overcome this:
+             * - Linking the individual nodes of the SPPath we have here, to the nodes of the NodePath::SubPath class as being
+             *   used in sp_nodepath_selected_nodes_move. This class has a member variable called "selected". For this the nodes
+             *   should be in the exact same order for both classes, so we can index them
+             * - Replacing the SPPath being used here by the NodePath::SubPath class; but how?
+             */
+        }
+
+        Geom::Point const sp_dt = dt->doc2dt(sp_doc);
+        if (!being_edited || (c1 && c2)) {
+            Geom::Coord dist = Geom::distance(sp_doc, p_doc);
+            // std::cout << "  dist -> " << dist << std::endl;
+            if (dist < tolerance) {
+                // Add the curve we have snapped to
+                Geom::Point sp_tangent_dt = Geom::Point(0,0);
+                if (p.getSourceType() == Inkscape::SNAPSOURCE_GUIDE_ORIGIN) {
+                    // We currently only use the tangent when snapping guides, so only in this case we will
+                    // actually calculate the tangent to avoid wasting CPU cycles
+                    Geom::Point sp_tangent_doc = curve->unitTangentAt(np);
+                    sp_tangent_dt = dt->doc2dt(sp_tangent_doc) - dt->doc2dt(Geom::Point(0,0));
                 }
-                num_path++;
-            } // End of: for (Geom::PathVector::iterator ....)
+                bool always = getSnapperAlwaysSnap(p.getSourceType());
+                isr.curves.emplace_back(sp_dt, sp_tangent_dt, num_path, index, dist, tolerance, always, false, curve, p.getSourceType(), p.getSourceNum(), it_p.target_type, it_p.target_bbox, _crossings_cache.get());
+                if (snap_tang || snap_perp) {
+                    // For each curve that's within snapping range, we will now also search for tangential and perpendicular snaps
+                    _snapPathsTangPerp(snap_tang, snap_perp, isr, p, curve, dt);
+                }
+            }
         }
     }
 }
@@ -585,31 +624,47 @@ void Inkscape::ObjectSnapper::_snapPathsConstrained(IntermSnapResults &isr,
 
     bool strict_snapping = _snapmanager->snapprefs.getStrictSnapping();
 
-    // Find all intersections of the constrained path with the snap target candidates
-    for (const auto & k : *_paths_to_snap_to) {
-        if (_allowSourceToSnapToTarget(p.getSourceType(), k.target_type, strict_snapping)) {
-            // Do the intersection math
-            std::vector<Geom::PVIntersection> inters = constraint_path.intersect(k.path_vector);
-
-            bool const being_edited = node_tool_active && k.currently_being_edited;
-
-            // Convert the collected intersections to snapped points
-            for (const auto & inter : inters) {
-                int index = inter.second.path_index; // index on the second path, which is the target path that we snapped to
-                Geom::Curve const *curve = &k.path_vector.at(index).at(inter.second.curve_index);
-
-                bool c1 = true;
-                bool c2 = true;
-                //TODO: Remove code duplication, see _snapPaths; it's documented in detail there
-                if (being_edited) {
-                    g_assert(unselected_nodes != nullptr);
-                    Geom::Point start_pt = dt->doc2dt(curve->pointAt(0));
-                    Geom::Point end_pt = dt->doc2dt(curve->pointAt(1));
-                    c1 = isUnselectedNode(start_pt, unselected_nodes);
-                    c2 = isUnselectedNode(end_pt, unselected_nodes);
-                }
+    if (!_paths_index->built()) {
+        _paths_index->build(*_paths_to_snap_to);
+    }
+
+    // Find all intersections of the constrained path with the snap target candidates, looking only
+    // at the curves whose bounds overlap those of the constrained path
+    auto const constraint_bounds = constraint_path.boundsFast();
+    if (!constraint_bounds) {
+        return;
+    }
+
+    for (auto const &segment : _paths_index->query(*constraint_bounds)) {
+        auto const &k = (*_paths_to_snap_to)[segment.path];
+        if (!_allowSourceToSnapToTarget(p.getSourceType(), k.target_type, strict_snapping)) {
+            continue;
+        }
+
+        Geom::Curve const *curve = &k.path_vector[segment.subpath].at(segment.curve);
+
+        bool const being_edited = node_tool_active && k.currently_being_edited;
+
+        bool c1 = true;
+        bool c2 = true;
+        //TODO: Remove code duplication, see _snapPaths; it's documented in detail there
+        if (being_edited) {
+            g_assert(unselected_nodes != nullptr);
+            Geom::Point start_pt = dt->doc2dt(curve->pointAt(0));
+            Geom::Point end_pt = dt->doc2dt(curve->pointAt(1));
+            c1 = isUnselectedNode(start_pt, unselected_nodes);
+            c2 = isUnselectedNode(end_pt, unselected_nodes);
+        }
+
+        if (being_edited && !(c1 && c2)) {
+            continue;
+        }
 
-                if (!being_edited || (c1 && c2)) {
+        // Do the intersection math
+        for (auto const &constraint : constraint_path) {
+            for (auto const &constraint_curve : constraint) {
+                // Convert the collected intersections to snapped points
+                for (auto const &inter : constraint_curve.intersect(*curve)) {
                     // Convert to desktop coordinates
                     Geom::Point p_inters = dt->doc2dt(inter.point());
                     // Construct a snapped point
@@ -730,6 +785,7 @@ bool Inkscape::ObjectSnapper::ThisSnapperMightSnap() const
 void Inkscape::ObjectSnapper::_clear_paths() const
 {
     _paths_to_snap_to->clear();
+    _paths_index->clear();
 }
 
 Geom::PathVector Inkscape::ObjectSnapper::_getPathvFromRect(Geom::Rect const rect) const
@@ -14,9 +14,12 @@
 #include <memory>
 #include "snapper.h"
 #include "snap-candidate.h"
+#include "snap-candidate-index.h"
+#include "snapped-curve.h"
 
 class SPDesktop;
 class SPNamedView;
+class SPDocument;
 class SPObject;
 class SPPath;
 class SPDesktop;
@@ -61,7 +64,11 @@ public:
 
 private:
     std::unique_ptr<std::vector<SnapCandidatePoint>> _points_to_snap_to;
+    std::unique_ptr<SnapCandidatePointIndex> _points_index;
     std::unique_ptr<std::vector<SnapCandidatePath >> _paths_to_snap_to;
+    std::unique_ptr<SnapCandidatePathIndex> _paths_index;
+    std::unique_ptr<CurveCrossingsCache> _crossings_cache;
+    mutable SPDocument const *_crossings_document = nullptr; // The document the cached crossings were found in
 
     void _snapNodes(IntermSnapResults &isr,
                       Inkscape::SnapCandidatePoint const &p, // in desktop coordinates
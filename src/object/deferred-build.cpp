@@ -0,0 +1,349 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Bookkeeping for objects whose construction has been put off until they are needed.
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include "deferred-build.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "document.h"
+#include "sp-object.h"
+#include "xml/node.h"
+#include "xml/node-observer.h"
+
+namespace Inkscape {
+namespace {
+
+struct ResourceKind
+{
+    char const *element;
+    char const *key;
+};
+
+// The resource lists each kind of element adds itself to when built, see SPDocument::addResource().
+ResourceKind const resource_kinds[] = {
+    // clang-format off
+    {"svg:linearGradient",    "gradient"},
+    {"svg:radialGradient",    "gradient"},
+    {"svg:meshgradient",      "gradient"},
+    {"svg:meshGradient",      "gradient"},
+    {"svg:mesh",              "gradient"},
+    {"svg:pattern",           "pattern"},
+    {"svg:hatch",             "hatch"},
+    {"svg:filter",            "filter"},
+    {"svg:feComponentTransfer", "feComponentTransfer"},
+    {"svg:feFuncR",           "fefuncnode"},
+    {"svg:feFuncG",           "fefuncnode"},
+    {"svg:feFuncB",           "fefuncnode"},
+    {"svg:feFuncA",           "fefuncnode"},
+    {"svg:feDistantLight",    "fedistantlight"},
+    {"svg:fePointLight",      "fepointlight"},
+    {"svg:feSpotLight",       "fespotlight"},
+    {"svg:clipPath",          "clipPath"},
+    {"svg:mask",              "mask"},
+    {"svg:symbol",            "symbol"},
+    {"svg:font",              "font"},
+    {"svg:image",             "image"},
+    {"svg:script",            "script"},
+    {"svg:color-profile",     "iccprofile"},
+    {"sodipodi:guide",        "guide"},
+    {"inkscape:page",         "page"},
+    {"inkscape:grid",         "grid"},
+    // clang-format on
+};
+
+char const *resource_kind(XML::Node const &node)
+{
+    auto const name = node.name();
+    if (!std::strcmp(name, "svg:g")) {
+        auto const mode = node.attribute("inkscape:groupmode");
+        return mode && !std::strcmp(mode, "layer") ? "layer" : nullptr;
+    }
+    for (auto const &kind : resource_kinds) {
+        if (!std::strcmp(name, kind.element)) {
+            return kind.key;
+        }
+    }
+    return nullptr;
+}
+
+bool is_resource_key(std::string const &key)
+{
+    return key == "layer" || std::any_of(std::begin(resource_kinds), std::end(resource_kinds), [&] (auto const &kind) {
+        return key == kind.key;
+    });
+}
+
+template <typename F>
+void for_each_element(XML::Node const &node, F &&f)
+{
+    if (node.type() != XML::NodeType::ELEMENT_NODE) {
+        return;
+    }
+    f(node);
+    for (auto child = node.firstChild(); child; child = child->next()) {
+        for_each_element(*child, f);
+    }
+}
+
+} // namespace
+
+/**
+ * Stands in for the object of a deferred node, keeping the index up to date as its subtree is edited.
+ */
+class DeferredBuild::Placeholder : public XML::NodeObserver
+{
+public:
+    Placeholder(DeferredBuild &owner, SPObject *parent, XML::Node *node)
+        : owner{owner}
+        , parent{parent}
+        , node{node}
+    {
+        node->addSubtreeObserver(*this);
+    }
+
+    ~Placeholder() override
+    {
+        node->removeSubtreeObserver(*this);
+    }
+
+    bool hasKind(std::string const &key) const
+    {
+        return std::find(kinds.begin(), kinds.end(), key) != kinds.end();
+    }
+
+    void addKind(char const *key)
+    {
+        if (!hasKind(key)) {
+            kinds.emplace_back(key);
+        }
+    }
+
+    void notifyChildAdded(XML::Node &, XML::Node &child, XML::Node *) override
+    {
+        owner.index(*this, child);
+    }
+
+    void notifyChildRemoved(XML::Node &, XML::Node &child, XML::Node *) override
+    {
+        owner.unindex(*this, child);
+    }
+
+    void notifyAttributeChanged(XML::Node &, GQuark name, Util::ptr_shared old_value, Util::ptr_shared new_value) override
+    {
+        static auto const id_quark = g_quark_from_static_string("id");
+        if (name != id_quark) {
+            return;
+        }
+        if (old_value) {
+            if (auto it = owner._ids.find(old_value.pointer()); it != owner._ids.end() && it->second == node) {
+                owner._ids.erase(it);
+            }
+        }
+        if (new_value) {
+            owner._ids.emplace(new_value.pointer(), node);
+        }
+    }
+
+    DeferredBuild &owner;
+    SPObject *parent;
+    XML::Node *node;
+    std::vector<std::string> kinds; ///< Resource lists the subtree would add itself to.
+};
+
+DeferredBuild::DeferredBuild(SPDocument *document)
+    : _document{document}
+{
+}
+
+DeferredBuild::~DeferredBuild() = default;
+
+bool DeferredBuild::defer(SPObject *parent, XML::Node *child)
+{
+    // If something is already waiting for an id in the subtree, it is needed straight away.
+    bool wanted = false;
+    for_each_element(*child, [&] (XML::Node const &node) {
+        if (auto id = node.attribute("id"); id && _document->isIdObserved(id)) {
+            wanted = true;
+        }
+    });
+    if (wanted) {
+        return false;
+    }
+
+    auto placeholder = std::make_unique<Placeholder>(*this, parent, child);
+    index(*placeholder, *child);
+    _nodes.emplace(child, std::move(placeholder));
+    return true;
+}
+
+void DeferredBuild::index(Placeholder &placeholder, XML::Node const &node)
+{
+    for_each_element(node, [&] (XML::Node const &element) {
+        if (auto id = element.attribute("id")) {
+            _ids.emplace(id, placeholder.node);
+        }
+        if (auto kind = resource_kind(element)) {
+            placeholder.addKind(kind);
+        }
+    });
+}
+
+void DeferredBuild::unindex(Placeholder &placeholder, XML::Node const &node)
+{
+    for_each_element(node, [&] (XML::Node const &element) {
+        if (auto id = element.attribute("id")) {
+            if (auto it = _ids.find(id); it != _ids.end() && it->second == placeholder.node) {
+                _ids.erase(it);
+            }
+        }
+    });
+}
+
+void DeferredBuild::build(XML::Node const *node)
+{
+    auto it = _nodes.find(node);
+    if (it == _nodes.end()) {
+        return;
+    }
+
+    auto placeholder = std::move(it->second);
+    _nodes.erase(it);
+    unindex(*placeholder, *node);
+
+    auto const parent = placeholder->parent;
+    auto const repr = placeholder->node;
+    placeholder.reset();
+
+    parent->buildDeferredChild(repr);
+
+    // Objects built outside an update need one, as if their node had just been added.
+    if (!_document->isUpdating()) {
+        if (auto object = _document->getObjectByRepr(repr)) {
+            object->requestDisplayUpdate(SP_OBJECT_MODIFIED_FLAG | SP_OBJECT_STYLE_MODIFIED_FLAG);
+        }
+    }
+}
+
+bool DeferredBuild::buildById(std::string const &id)
+{
+    bool built = false;
+
+    // Building a subtree may defer part of it again, so keep going until the id has an object.
+    for (auto it = _ids.find(id); it != _ids.end(); it = _ids.find(id)) {
+        if (!contains(it->second)) {
+            _ids.erase(it);
+            break;
+        }
+        build(it->second);
+        built = true;
+    }
+
+    return built;
+}
+
+bool DeferredBuild::buildByNode(XML::Node const *node)
+{
+    if (empty()) {
+        return false;
+    }
+
+    bool built = false;
+
+    for (auto ancestor = node; ancestor; ) {
+        if (contains(ancestor)) {
+            build(ancestor);
+            built = true;
+            ancestor = node;
+        } else {
+            ancestor = ancestor->parent();
+        }
+    }
+
+    return built;
+}
+
+void DeferredBuild::buildResources(std::string const &key)
+{
+    if (!is_resource_key(key)) {
+        buildAll();
+        return;
+    }
+
+    while (true) {
+        std::vector<XML::Node const *> nodes;
+        for (auto const &[node, placeholder] : _nodes) {
+            if (placeholder->hasKind(key)) {
+                nodes.push_back(node);
+            }
+        }
+        if (nodes.empty()) {
+            break;
+        }
+        for (auto node : nodes) {
+            build(node);
+        }
+    }
+}
+
+bool DeferredBuild::buildChildren(SPObject const *parent, bool first_only)
+{
+    bool built = false;
+
+    for (auto child = parent->getRepr()->firstChild(); child; child = child->next()) {
+        if (auto it = _nodes.find(child); it != _nodes.end() && it->second->parent == parent) {
+            build(child);
+            built = true;
+            if (first_only) {
+                break;
+            }
+        }
+    }
+
+    return built;
+}
+
+void DeferredBuild::buildAll()
+{
+    while (!_nodes.empty()) {
+        build(_nodes.begin()->first);
+    }
+}
+
+void DeferredBuild::forget(XML::Node const *node)
+{
+    if (auto it = _nodes.find(node); it != _nodes.end()) {
+        unindex(*it->second, *node);
+        _nodes.erase(it);
+    }
+}
+
+void DeferredBuild::forgetChildren(SPObject const *parent)
+{
+    for (auto child = parent->getRepr()->firstChild(); child; child = child->next()) {
+        if (auto it = _nodes.find(child); it != _nodes.end() && it->second->parent == parent) {
+            forget(child);
+        }
+    }
+}
+
+} // namespace Inkscape
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
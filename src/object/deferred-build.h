@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Bookkeeping for objects whose construction has been put off until they are needed.
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#ifndef SEEN_SP_DEFERRED_BUILD_H
+#define SEEN_SP_DEFERRED_BUILD_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class SPDocument;
+class SPObject;
+
+namespace Inkscape {
+namespace XML {
+class Node;
+} // namespace XML
+
+/**
+ * The parts of a document's object tree that have been left as bare XML.
+ *
+ * When a document is opened with lazy building, the children of hidden layers and unused
+ * resources in <defs> are not built along with the rest of the tree. Each such child node is
+ * recorded here together with the object that would have been its parent, and is built the
+ * first time it is needed: when an id in its subtree is looked up, when a node in its subtree is
+ * looked up, when a list of resources it would contribute to is requested, or when its parent
+ * asks for all of its children.
+ *
+ * Each deferred node carries a subtree observer that keeps the index of ids and resource kinds
+ * in step with edits to the XML, so the subtree can still be found after it has been changed.
+ * Everything else is read from the XML when the subtree is finally built.
+ */
+class DeferredBuild
+{
+public:
+    explicit DeferredBuild(SPDocument *document);
+    ~DeferredBuild();
+
+    DeferredBuild(DeferredBuild const &) = delete;
+    DeferredBuild &operator=(DeferredBuild const &) = delete;
+
+    bool empty() const { return _nodes.empty(); }
+    bool contains(XML::Node const *node) const { return _nodes.contains(node); }
+
+    /**
+     * Put off building the object for child, a child node of parent's repr.
+     * Returns false without deferring anything if an id in the subtree is already being waited for.
+     */
+    bool defer(SPObject *parent, XML::Node *child);
+
+    /// Build the deferred subtree that contains the given id. Returns whether anything was built.
+    bool buildById(std::string const &id);
+
+    /// Build the deferred subtree that contains the given node. Returns whether anything was built.
+    bool buildByNode(XML::Node const *node);
+
+    /// Build every deferred subtree that would add resources of the given kind.
+    void buildResources(std::string const &key);
+
+    /// Build the deferred children of parent, or only the first of them. Returns whether anything was built.
+    bool buildChildren(SPObject const *parent, bool first_only = false);
+
+    /// Build everything that is still deferred.
+    void buildAll();
+
+    /// Forget a deferred node that has been removed from the XML tree.
+    void forget(XML::Node const *node);
+
+    /// Forget the deferred children of an object that is being released.
+    void forgetChildren(SPObject const *parent);
+
+private:
+    class Placeholder;
+
+    void build(XML::Node const *node);
+    void index(Placeholder &placeholder, XML::Node const &node);
+    void unindex(Placeholder &placeholder, XML::Node const &node);
+
+    SPDocument *_document;
+    std::unordered_map<XML::Node const *, std::unique_ptr<Placeholder>> _nodes;
+    std::unordered_map<std::string, XML::Node const *> _ids;
+};
+
+} // namespace Inkscape
+
+#endif // SEEN_SP_DEFERRED_BUILD_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -19,6 +19,9 @@
 
 #include "sp-defs.h"
 
+#include <algorithm>                                 // for any_of
+#include <cstring>                                   // for strcmp
+
 #include "attributes.h"                              // for SPAttr
 #include "object/sp-object.h"                        // for SPObject, sp_obj...
 #include "xml/document.h"                            // for Document
@@ -40,6 +43,24 @@ void SPDefs::release() {
 	SPObject::release();
 }
 
+/**
+ * Definitions that do nothing until something refers to them can be built on first use.
+ */
+bool SPDefs::canDeferChild(Inkscape::XML::Node const &child) const {
+    // Markers are left out: they are listed straight from the children of <defs> in the UI.
+    static char const *const deferrable[] = {
+        "svg:linearGradient", "svg:radialGradient", "svg:meshgradient", "svg:pattern", "svg:hatch",
+        "svg:filter", "svg:clipPath", "svg:mask", "svg:symbol",
+    };
+
+    if (child.type() != Inkscape::XML::NodeType::ELEMENT_NODE) {
+        return false;
+    }
+    return std::any_of(std::begin(deferrable), std::end(deferrable), [&] (char const *name) {
+        return !std::strcmp(child.name(), name);
+    });
+}
+
 void SPDefs::update(SPCtx *ctx, guint flags) {
     if (flags & SP_OBJECT_MODIFIED_FLAG) {
         flags |= SP_OBJECT_PARENT_MODIFIED_FLAG;
@@ -25,6 +25,7 @@ public:
 protected:
         void build(SPDocument* doc, Inkscape::XML::Node* repr) override;
 	void release() override;
+	bool canDeferChild(Inkscape::XML::Node const &child) const override;
 	void update(SPCtx* ctx, unsigned int flags) override;
 	void modified(unsigned int flags) override;
 	Inkscape::XML::Node* write(Inkscape::XML::Document *xml_doc, Inkscape::XML::Node *repr, unsigned int flags) override;
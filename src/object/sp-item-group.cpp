@@ -27,6 +27,7 @@
 #include "style.h"
 
 #include "box3d.h"
+#include "deferred-build.h"
 #include "object-set.h"
 #include "sp-clippath.h"
 #include "sp-defs.h"
@@ -135,6 +136,39 @@ void SPGroup::order_changed (Inkscape::XML::Node *child, Inkscape::XML::Node *ol
     this->requestModified(SP_OBJECT_MODIFIED_FLAG);
 }
 
+/**
+ * The contents of a hidden layer can be built once the layer is shown.
+ * Title and description are kept, as they label the layer itself.
+ */
+/**
+ * Whether a subtree holds a stylesheet, which applies to the whole document as soon as it is loaded.
+ */
+static bool contains_stylesheet(Inkscape::XML::Node const &node)
+{
+    if (node.type() != Inkscape::XML::NodeType::ELEMENT_NODE) {
+        return false;
+    }
+    if (!std::strcmp(node.name(), "svg:style")) {
+        return true;
+    }
+    for (auto child = node.firstChild(); child; child = child->next()) {
+        if (contains_stylesheet(*child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SPGroup::canDeferChild(Inkscape::XML::Node const &child) const
+{
+    return isLayer()
+        && style->display.computed == SP_CSS_DISPLAY_NONE
+        && child.type() == Inkscape::XML::NodeType::ELEMENT_NODE
+        && std::strcmp(child.name(), "svg:title") != 0
+        && std::strcmp(child.name(), "svg:desc") != 0
+        && !contains_stylesheet(child);
+}
+
 void SPGroup::update(SPCtx *ctx, unsigned int flags) {
     // std::cout << "SPGroup::update(): " << (getId()?getId():"null") << std::endl;
     SPItemCtx *ictx, cctx;
@@ -142,6 +176,13 @@ void SPGroup::update(SPCtx *ctx, unsigned int flags) {
     ictx = (SPItemCtx *) ctx;
     cctx = *ictx;
 
+    // A hidden layer that has just been shown builds the contents it was loaded without.
+    if (auto deferred = document->getDeferredBuild(); deferred && !deferred->empty() && isLayer() && !isHidden()) {
+        if (deferred->buildChildren(this)) {
+            flags |= SP_OBJECT_MODIFIED_FLAG;
+        }
+    }
+
     unsigned childflags = flags;
 
     if (flags & SP_OBJECT_MODIFIED_FLAG) {
@@ -72,6 +72,7 @@ public:
     void child_added(Inkscape::XML::Node* child, Inkscape::XML::Node* ref) override;
     void remove_child(Inkscape::XML::Node *child) override;
     void order_changed(Inkscape::XML::Node *child, Inkscape::XML::Node *old_ref, Inkscape::XML::Node *new_ref) override;
+    bool canDeferChild(Inkscape::XML::Node const &child) const override;
 
     void update(SPCtx *ctx, unsigned int flags) override;
     void modified(unsigned int flags) override;
@@ -75,7 +75,6 @@ SPItemView::SPItemView(unsigned flags, unsigned key, DrawingItemPtr<Inkscape::Dr
 SPItem::SPItem()
 {
     sensitive = TRUE;
-    bbox_valid = FALSE;
 
     transform_center_x = 0;
     transform_center_y = 0;
@@ -85,7 +84,6 @@ SPItem::SPItem()
     _evaluated_status = StatusUnknown;
 
     transform = Geom::identity();
-    // doc_bbox = Geom::OptRect();
 
     clip_ref = nullptr;
     mask_ref = nullptr;
@@ -770,7 +768,7 @@ void SPItem::update(SPCtx *ctx, unsigned flags)
 
     // Any of the modifications defined in sp-object.h might change bbox,
     // so we invalidate it unconditionally
-    bbox_valid = false;
+    document->geometry_epoch++;
 
     viewport = ictx->viewport; // Cache viewport
 
@@ -981,6 +979,12 @@ Geom::OptRect SPItem::visualBounds(Geom::Affine const &transform, bool wfilter,
 
 Geom::OptRect SPItem::bounds(BBoxType type, Geom::Affine const &transform) const
 {
+    // Groups ask their children for bounds in document coordinates when they are asked for
+    // their own, so this lets nested groups share their children's cached results.
+    if (transform == i2doc_affine()) {
+        return documentBounds(type);
+    }
+
     if (type == GEOMETRIC_BBOX) {
         return geometricBounds(transform);
     } else {
@@ -999,24 +1003,52 @@ Geom::OptRect SPItem::documentPreferredBounds() const
 
 Geom::OptRect SPItem::documentGeometricBounds() const
 {
-    return geometricBounds(i2doc_affine());
+    return documentBounds(GEOMETRIC_BBOX);
 }
 
 Geom::OptRect SPItem::documentVisualBounds() const
 {
-    if (!bbox_valid) {
-        doc_bbox = visualBounds(i2doc_affine());
-        bbox_valid = true;
-    }
-    return doc_bbox;
+    return documentBounds(VISUAL_BBOX);
 }
+
 Geom::OptRect SPItem::documentBounds(BBoxType type) const
 {
-    if (type == GEOMETRIC_BBOX) {
-        return documentGeometricBounds();
-    } else {
-        return documentVisualBounds();
+    auto const i2doc = i2doc_affine();
+    if (!document) {
+        return type == GEOMETRIC_BBOX ? geometricBounds(i2doc) : visualBounds(i2doc);
+    }
+    auto const epoch = _bounds_cache.epoch;
+
+    auto &cached = type == GEOMETRIC_BBOX ? _bounds_cache.geometric : _bounds_cache.visual;
+    if (cached) {
+        return *cached;
     }
+
+    auto const bbox = type == GEOMETRIC_BBOX ? geometricBounds(i2doc) : visualBounds(i2doc);
+
+    // Only keep the result if nothing was invalidated while computing it.
+    if (_bounds_cache.epoch == epoch && document->geometry_epoch == epoch) {
+        cached = bbox;
+    }
+    return bbox;
+}
+
+/**
+ * Returns the bounds cache, emptied first if the document or the item's own transform has
+ * changed since it was filled.
+ */
+SPItem::BoundsCache &SPItem::validBoundsCache() const
+{
+    auto const root = cast<SPRoot>(this);
+    auto const &own = root ? root->c2p : transform;
+
+    if (_bounds_cache.epoch != document->geometry_epoch || _bounds_cache.transform != own) {
+        _bounds_cache = {};
+        _bounds_cache.epoch = document->geometry_epoch;
+        _bounds_cache.transform = own;
+    }
+
+    return _bounds_cache;
 }
 
 std::optional<Geom::PathVector> SPItem::documentExactBounds() const
@@ -1030,7 +1062,11 @@ std::optional<Geom::PathVector> SPItem::documentExactBounds() const
 
 Geom::OptRect SPItem::desktopGeometricBounds() const
 {
-    return geometricBounds(i2dt_affine());
+    Geom::OptRect ret = documentGeometricBounds();
+    if (ret) {
+        *ret *= document->doc2dt();
+    }
+    return ret;
 }
 
 Geom::OptRect SPItem::desktopVisualBounds() const
@@ -1740,6 +1776,10 @@ void SPItem::doWriteTransform(Geom::Affine const &transform, Geom::Affine const
     }
     set_item_transform(transform_attr);
 
+    // set_transform() may have moved the geometry without changing the transform attribute,
+    // which leaves both this item's cached bounds and those of its ancestors out of date
+    document->geometry_epoch++;
+
     // Note: updateRepr comes before emitting the transformed signal since
     // it causes clone SPUse's copy of the original object to be brought up to
     // date with the original. Otherwise, sp_use_bbox returns incorrect
@@ -1760,6 +1800,10 @@ void SPItem::set_item_transform(Geom::Affine const &transform_matrix)
 {
     if (!Geom::are_near(transform_matrix, transform, 1e-18)) {
         transform = transform_matrix;
+        // The cached bounds of every ancestor include this item, so they are out of date too
+        if (document) {
+            document->geometry_epoch++;
+        }
         /* The SP_OBJECT_USER_MODIFIED_FLAG_B is used to mark the fact that it's only a
            transformation.  It's apparently not used anywhere else. */
         requestDisplayUpdate(SP_OBJECT_MODIFIED_FLAG | SP_OBJECT_USER_MODIFIED_FLAG_B);
@@ -1802,7 +1846,27 @@ Geom::Affine SPItem::getRelativeTransform(SPObject const *dest) const {
 
 Geom::Affine SPItem::i2doc_affine() const
 {
-    return i2anc_affine(this, nullptr);
+    if (!document) {
+        return i2anc_affine(this, nullptr);
+    }
+
+    auto &cache = validBoundsCache();
+
+    // Same as i2anc_affine(), but reusing the parent's cached transform. Checking it against the
+    // one used before also catches ancestors whose transform was changed without a request.
+    if (auto const parent_item = cast<SPItem>(parent)) {
+        auto const parent_i2doc = parent_item->i2doc_affine();
+        if (cache.parent_i2doc != parent_i2doc) {
+            cache = {cache.epoch, cache.transform, parent_i2doc};
+        }
+        if (!cache.i2doc) {
+            cache.i2doc = cache.transform * parent_i2doc;
+        }
+    } else if (!cache.i2doc) {
+        cache.i2doc = cache.transform;
+    }
+
+    return *cache.i2doc;
 }
 
 Geom::Affine SPItem::i2dt_affine() const
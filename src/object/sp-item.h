@@ -22,6 +22,7 @@
  */
 
 #include <cstdint>
+#include <optional>
 #include <vector>
 #include <2geom/forward.h>
 #include <2geom/affine.h>
@@ -126,7 +127,6 @@ public:
 
     unsigned int sensitive : 1;
     unsigned int stop_paint: 1;
-    mutable unsigned bbox_valid : 1;
     double transform_center_x;
     double transform_center_y;
     bool freeze_stroke_width;
@@ -136,7 +136,6 @@ public:
     bool _is_expanded = false;
 
     Geom::Affine transform;
-    mutable Geom::OptRect doc_bbox;
     Geom::Rect viewport;  // Cache viewport information
 
     SPClipPath *getClipObject() const;
@@ -266,9 +265,20 @@ public:
      */
     Geom::OptRect documentVisualBounds() const;
 
+    /**
+     * Get item's bbox in document coordinate system.
+     * The result is cached until the document's geometry epoch moves on, so repeated calls
+     * on an unchanged document are cheap. APPROXIMATE_BBOX is treated as VISUAL_BBOX.
+     */
     Geom::OptRect documentBounds(BBoxType type) const;
     Geom::OptRect documentPreferredBounds() const;
 
+    /**
+     * Forget the cached document bounds and i2doc transform of this item.
+     * Only needed after changing geometry without requesting an update.
+     */
+    void invalidateBoundsCache() const { _bounds_cache.epoch = 0; }
+
     /**
      * Get an exact geometric shape representing the visual bounds of the item in the document
      * coordinates. This is different than a simple bounding rectangle aligned to the coordinate axes:
@@ -421,6 +431,23 @@ private:
     mutable bool _is_evaluated;
     mutable EvaluatedStatus _evaluated_status;
 
+    /**
+     * Document bounds and i2doc transform, valid while epoch matches the document's geometry
+     * epoch, transform matches the item's own transform and parent_i2doc matches the parent's.
+     */
+    struct BoundsCache
+    {
+        std::uint64_t epoch = 0;
+        Geom::Affine transform;
+        Geom::Affine parent_i2doc;
+        std::optional<Geom::Affine> i2doc;
+        std::optional<Geom::OptRect> geometric;
+        std::optional<Geom::OptRect> visual;
+    };
+    mutable BoundsCache _bounds_cache;
+
+    BoundsCache &validBoundsCache() const;
+
     void clip_ref_changed(SPObject *old_clip, SPObject *clip);
     void mask_ref_changed(SPObject *old_mask, SPObject *mask);
     void fill_ps_ref_changed(SPObject *old_ps, SPObject *ps);
@@ -27,6 +27,7 @@
 #include "attributes.h"
 #include "attribute-rel-util.h"
 #include "color-profile.h"
+#include "deferred-build.h"
 #include "document.h"
 #include "io/fix-broken-links.h"
 #include "preferences.h"
@@ -698,6 +699,11 @@ static SPObject *get_closest_child_by_repr(SPObject &obj, Inkscape::XML::Node *r
             return result;
         }
 
+        // Skip siblings whose objects have not been built yet
+        if (auto deferred = obj.document->getDeferredBuild(); deferred && deferred->contains(ref)) {
+            continue;
+        }
+
         // Only continue if `ref` is not an SPObject, but e.g. an XML comment
         if (obj.document->getObjectByRepr(ref)) {
             break;
@@ -797,7 +803,13 @@ void SPObject::build(SPDocument *document, Inkscape::XML::Node *repr) {
                                                    // stuff externally modified to have no id. 
         object->clone_original = document->getObjectById(repr->attribute("id"));
 
+    auto const deferred = object->cloned ? nullptr : document->getDeferredBuild();
+
     for (Inkscape::XML::Node *rchild = repr->firstChild() ; rchild != nullptr; rchild = rchild->next()) {
+        if (deferred && object->canDeferChild(*rchild) && deferred->defer(object, rchild)) {
+            continue;
+        }
+
         const std::string typeString = NodeTraits::get_type_string(*rchild);
 
         SPObject* child = SPFactory::createObject(typeString);
@@ -883,6 +895,11 @@ void SPObject::invoke_build(SPDocument *document, Inkscape::XML::Node *repr, uns
 #endif
 }
 
+void SPObject::buildDeferredChild(Inkscape::XML::Node *child)
+{
+    child_added(child, child->prev());
+}
+
 int SPObject::getIntAttribute(char const *key, int def)
 {
     return getRepr()->getAttributeInt(key, def);
@@ -929,6 +946,10 @@ void SPObject::releaseReferences() {
 
     repr->removeObserver(*this);
 
+    if (auto deferred = document->getDeferredBuild()) {
+        deferred->forgetChildren(this);
+    }
+
     this->_release_signal.emit(this);
 
     this->release();
@@ -982,12 +1003,19 @@ void SPObject::notifyChildAdded(Inkscape::XML::Node &node, Inkscape::XML::Node &
 
 void SPObject::notifyChildRemoved(Inkscape::XML::Node &, Inkscape::XML::Node &child, Inkscape::XML::Node *)
 {
+    if (auto deferred = document->getDeferredBuild()) {
+        deferred->forget(&child);
+    }
     remove_child(&child);
 }
 
 void SPObject::notifyChildOrderChanged(Inkscape::XML::Node &, Inkscape::XML::Node &child, Inkscape::XML::Node *old_prev,
                                        Inkscape::XML::Node *new_prev)
 {
+    // A child that has not been built yet has no object to move
+    if (auto deferred = document->getDeferredBuild(); deferred && deferred->contains(&child)) {
+        return;
+    }
     order_changed(&child, old_prev, new_prev);
 }
 
@@ -1420,6 +1448,9 @@ void SPObject::requestDisplayUpdate(unsigned int flags)
     objectTrace( "SPObject::requestDisplayUpdate" );
 #endif
 
+    // Any cached bounds or transforms may now be out of date
+    document->geometry_epoch++;
+
     bool already_propagated = (!(this->uflags & (SP_OBJECT_MODIFIED_FLAG | SP_OBJECT_CHILD_MODIFIED_FLAG)));
     //https://stackoverflow.com/a/7841333
     if ((this->uflags & flags) !=  flags ) {
@@ -1516,6 +1547,8 @@ void SPObject::requestModified(unsigned int flags)
     objectTrace( "SPObject::requestModified" );
 #endif
 
+    document->geometry_epoch++;
+
     bool already_propagated = (!(this->mflags & (SP_OBJECT_MODIFIED_FLAG | SP_OBJECT_CHILD_MODIFIED_FLAG)));
 
     this->mflags |= flags;
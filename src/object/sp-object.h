@@ -761,6 +761,12 @@ public:
 
     void invoke_build(SPDocument *document, Inkscape::XML::Node *repr, unsigned int cloned);
 
+    /**
+     * Build the object for a child node that was skipped when this object was built, as if the
+     * node had just been added. See Inkscape::DeferredBuild.
+     */
+    void buildDeferredChild(Inkscape::XML::Node *child);
+
     int getIntAttribute(char const *key, int def);
 
     unsigned getPosition();
@@ -882,6 +888,12 @@ protected:
     virtual void child_added(Inkscape::XML::Node *child, Inkscape::XML::Node *ref);
     virtual void remove_child(Inkscape::XML::Node *child);
 
+    /**
+     * Whether building the object for a child node may be put off until it is needed, when the
+     * document is built lazily.
+     */
+    virtual bool canDeferChild(Inkscape::XML::Node const &/*child*/) const { return false; }
+
     virtual void order_changed(Inkscape::XML::Node *child, Inkscape::XML::Node *old_repr,
                                Inkscape::XML::Node *new_repr);
     virtual void tag_name_changed(gchar const *oldname, gchar const *newname);
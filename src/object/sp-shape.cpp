@@ -954,6 +954,10 @@ void SPShape::setCurveBeforeLPE(SPCurve const *new_curve)
 void SPShape::setCurveInsync(SPCurve new_curve)
 {
     _curve = std::make_shared<SPCurve>(std::move(new_curve));
+    if (document) {
+        // No update is requested, but cached bounds are still out of date
+        document->geometry_epoch++;
+    }
 }
 void SPShape::setCurveInsync(SPCurve const *new_curve)
 {
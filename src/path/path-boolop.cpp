@@ -13,6 +13,8 @@
 
 #include "path-boolop.h"
 
+#include <algorithm>
+#include <memory>
 #include <vector>
 
 #include <glibmm/i18n.h>
@@ -28,6 +30,8 @@
 #include "path-util.h"
 
 #include "display/curve.h"
+#include "display/dispatch-pool.h"
+#include "display/threading.h"
 #include "livarot/Path.h"
 #include "livarot/Shape.h"
 #include "object/object-set.h"  // This file defines some member functions of ObjectSet.
@@ -333,6 +337,72 @@ Geom::PathVector sp_pathvector_boolop(Geom::PathVector const &pathva, Geom::Path
     return result.MakePathVector();
 }
 
+// Apply the operation to A (the operands so far) and B (the next operand), storing the result in A.
+static void combine_shapes(std::unique_ptr<Shape> &shapeA, std::unique_ptr<Shape> &shapeB, BooleanOp bop)
+{
+    /* Due to quantization of the input shape coordinates, we may end up with A or B being empty.
+     * If this is a union or symdiff operation, we just use the non-empty shape as the result:
+     *   A=0  =>  (0 or B) == B
+     *   B=0  =>  (A or 0) == A
+     *   A=0  =>  (0 xor B) == B
+     *   B=0  =>  (A xor 0) == A
+     * If this is an intersection operation, we just use the empty shape as the result:
+     *   A=0  =>  (0 and B) == 0 == A
+     *   B=0  =>  (A and 0) == 0 == B
+     * If this a difference operation, and the upper shape (A) is empty, we keep B.
+     * If the lower shape (B) is empty, we still keep B, as it's empty:
+     *   A=0  =>  (B - 0) == B
+     *   B=0  =>  (0 - A) == 0 == B
+     *
+     * In any case, the output from this operation is stored in shape A, so we may apply
+     * the above rules simply by judicious use of swapping A and B where necessary.
+     */
+    bool zeroA = shapeA->numberOfEdges() == 0;
+    bool zeroB = shapeB->numberOfEdges() == 0;
+    if (zeroA || zeroB) {
+        // We might need to do a swap. Apply the above rules depending on operation type.
+        bool resultIsB =   ((bop == bool_op_union || bop == bool_op_symdiff) && zeroA)
+                           || ((bop == bool_op_inters) && zeroB)
+                           ||  (bop == bool_op_diff);
+        if (resultIsB) {
+            // Swap A and B to use B as the result
+            std::swap(shapeA, shapeB);
+        }
+    } else {
+        // Just do the Boolean operation as usual
+        // les elements arrivent en ordre inverse dans la liste
+        auto result = std::make_unique<Shape>();
+        result->Booleen(shapeB.get(), shapeA.get(), bop);
+        shapeA = std::move(result);
+    }
+    shapeB.reset();
+}
+
+void boolop_shapes(std::vector<std::unique_ptr<Shape>> &shapes, BooleanOp bop, int tree_min_operands)
+{
+    int const count = shapes.size();
+    auto const pool = Inkscape::get_global_dispatch_pool();
+
+    if (bop == bool_op_diff || count < tree_min_operands) {
+        for (int i = 1; i < count; i++) {
+            combine_shapes(shapes[0], shapes[i], bop);
+        }
+    } else {
+        // Union, intersection and exclusion are associative and commutative, so combine the operands pairwise
+        // in a balanced tree. Folding them one by one re-sweeps an ever growing result, which is quadratic for
+        // large selections; the pairs on each level are also independent and can be done in parallel.
+        for (int step = 1; step < count; step *= 2) {
+            int const pairs = (count - 1) / (2 * step) + 1;
+            pool->dispatch_threshold(pairs, pairs > 1, [&] (int k, int) {
+                int const i = 2 * step * k;
+                if (i + step < count) {
+                    combine_shapes(shapes[i], shapes[i + step], bop);
+                }
+            });
+        }
+    }
+}
+
 void Inkscape::ObjectSet::_pathBoolOp(BooleanOp bop, char const *icon_name, char const *description, bool skip_undo, bool silent)
 {
     try {
@@ -483,9 +553,28 @@ void Inkscape::ObjectSet::_pathBoolOp(BooleanOp bop)
     }
 
     // Compute the intersections and self-intersections, and use this information when converting to livarot paths.
+    // Only operands with overlapping bounding boxes can intersect, so sweep over the operands sorted by their left
+    // edge instead of intersecting every pair.
+    std::vector<Geom::OptRect> bounds;
+    std::vector<int> by_left;
     for (int i = 0; i < operands.size(); i++) {
-        for (int j = 0; j < i; j++) {
-            distribute_intersection_times(operands[i].cuts, operands[j].cuts, operands[i].pathv.intersect(operands[j].pathv));
+        bounds.emplace_back(operands[i].pathv.boundsFast());
+        if (bounds.back()) {
+            by_left.emplace_back(i);
+        }
+    }
+    std::sort(by_left.begin(), by_left.end(), [&] (int a, int b) { return bounds[a]->left() < bounds[b]->left(); });
+
+    for (int a = 0; a < by_left.size(); a++) {
+        for (int b = a + 1; b < by_left.size(); b++) {
+            if (bounds[by_left[b]]->left() > bounds[by_left[a]]->right()) {
+                break;
+            }
+            auto const i = std::max(by_left[a], by_left[b]);
+            auto const j = std::min(by_left[a], by_left[b]);
+            if (bounds[i]->intersects(*bounds[j])) {
+                distribute_intersection_times(operands[i].cuts, operands[j].cuts, operands[i].pathv.intersect(operands[j].pathv));
+            }
         }
     }
 
@@ -519,54 +608,22 @@ void Inkscape::ObjectSet::_pathBoolOp(BooleanOp bop)
 
     if (bop == bool_op_inters || bop == bool_op_union || bop == bool_op_diff || bop == bool_op_symdiff) {
         // true boolean op
-        // get the polygons of each path, with the winding rule specified, and apply the operation iteratively
-
-        operands[0].path->Fill(theShape, 0);
-
-        theShapeA->ConvertToShape(theShape, operands[0].fill_rule);
-
-        for (int i = 1; i < operands.size(); i++) {
-            operands[i].path->Fill(theShape, i);
-
-            theShapeB->ConvertToShape(theShape, operands[i].fill_rule);
-
-            /* Due to quantization of the input shape coordinates, we may end up with A or B being empty.
-             * If this is a union or symdiff operation, we just use the non-empty shape as the result:
-             *   A=0  =>  (0 or B) == B
-             *   B=0  =>  (A or 0) == A
-             *   A=0  =>  (0 xor B) == B
-             *   B=0  =>  (A xor 0) == A
-             * If this is an intersection operation, we just use the empty shape as the result:
-             *   A=0  =>  (0 and B) == 0 == A
-             *   B=0  =>  (A and 0) == 0 == B
-             * If this a difference operation, and the upper shape (A) is empty, we keep B.
-             * If the lower shape (B) is empty, we still keep B, as it's empty:
-             *   A=0  =>  (B - 0) == B
-             *   B=0  =>  (0 - A) == 0 == B
-             *
-             * In any case, the output from this operation is stored in shape A, so we may apply
-             * the above rules simply by judicious use of swapping A and B where necessary.
-             */
-            bool zeroA = theShapeA->numberOfEdges() == 0;
-            bool zeroB = theShapeB->numberOfEdges() == 0;
-            if (zeroA || zeroB) {
-                // We might need to do a swap. Apply the above rules depending on operation type.
-                bool resultIsB =   ((bop == bool_op_union || bop == bool_op_symdiff) && zeroA)
-                                   || ((bop == bool_op_inters) && zeroB)
-                                   ||  (bop == bool_op_diff);
-                if (resultIsB) {
-                    // Swap A and B to use B as the result
-                    std::swap(theShapeA, theShapeB);
-                }
-            } else {
-                // Just do the Boolean operation as usual
-                // les elements arrivent en ordre inverse dans la liste
-                theShape->Booleen(theShapeB, theShapeA, bop);
-                std::swap(theShape, theShapeA);
-            }
-        }
-
-        std::swap(theShape, theShapeA);
+        // get the polygons of each path, with the winding rule specified, and apply the operation
+        auto const pool = get_global_dispatch_pool();
+        int const count = operands.size();
+
+        std::vector<std::unique_ptr<Shape>> shapes(count);
+        pool->dispatch_threshold(count, count >= BOOLOP_TREE_MIN_OPERANDS, [&] (int i, int) {
+            Shape polygon;
+            operands[i].path->Fill(&polygon, i);
+            shapes[i] = std::make_unique<Shape>();
+            shapes[i]->ConvertToShape(&polygon, operands[i].fill_rule);
+        });
+
+        boolop_shapes(shapes, bop);
+
+        delete theShape;
+        theShape = shapes[0].release();
 
     } else if (bop == bool_op_cut) {
         // cuts= sort of a bastard boolean operation, thus not the axact same modus operandi
@@ -10,12 +10,19 @@
 #ifndef PATH_BOOLOP_H
 #define PATH_BOOLOP_H
 
+#include <memory>
 #include <vector>
 
 #include <2geom/forward.h>
 
 #include "livarot/LivarotDefs.h" // FillRule, BooleanOp
 
+class Shape;
+
+/// Selections with at least this many operands are combined in a balanced tree, in parallel.
+/// Smaller ones are folded in selection order, as they always have been.
+constexpr int BOOLOP_TREE_MIN_OPERANDS = 16;
+
 /// Flatten a pathvector according to the given fill rule.
 Geom::PathVector flattened(Geom::PathVector const &pathv, FillRule fill_rule);
 void flatten(Geom::PathVector &pathv, FillRule fill_rule);
@@ -26,6 +33,14 @@ std::vector<Geom::PathVector> pathvector_cut(Geom::PathVector const &pathv, Geom
 /// Perform a boolean operation on two pathvectors.
 Geom::PathVector sp_pathvector_boolop(Geom::PathVector const &pathva, Geom::PathVector const &pathvb, BooleanOp bop, FillRule fra, FillRule frb);
 
+/**
+ * Combine the polygons of the operands of a boolean operation, leaving the result in the first.
+ * Union, intersection and exclusion of at least tree_min_operands operands are combined pairwise
+ * in a balanced tree; anything else is folded in order.
+ */
+void boolop_shapes(std::vector<std::unique_ptr<Shape>> &shapes, BooleanOp bop,
+                   int tree_min_operands = BOOLOP_TREE_MIN_OPERANDS);
+
 #endif // PATH_BOOLOP_H
 
 /*
@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Spatial lookup of snap target points and paths.
+ *
+ * Copyright (C) 2025 Authors
+ *
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include "snap-candidate-index.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Inkscape {
+
+void SnapCandidatePointIndex::build(std::vector<SnapCandidatePoint> const &points)
+{
+    clear();
+
+    _points.reserve(points.size());
+    for (auto const &point : points) {
+        _points.emplace_back(point.getPoint());
+    }
+
+    for (auto d : {Geom::X, Geom::Y}) {
+        auto &sorted = _sorted[d];
+        sorted.reserve(_points.size());
+        for (int i = 0; i < _points.size(); i++) {
+            sorted.emplace_back(_points[i][d], i);
+        }
+        std::sort(sorted.begin(), sorted.end());
+    }
+
+    _built = true;
+}
+
+void SnapCandidatePointIndex::clear()
+{
+    _points.clear();
+    _sorted[Geom::X].clear();
+    _sorted[Geom::Y].clear();
+    _built = false;
+}
+
+std::pair<std::vector<SnapCandidatePointIndex::Entry>::const_iterator, std::vector<SnapCandidatePointIndex::Entry>::const_iterator>
+SnapCandidatePointIndex::_range(Geom::Dim2 d, Geom::Coord min, Geom::Coord max) const
+{
+    auto const &sorted = _sorted[d];
+    auto const begin = std::lower_bound(sorted.begin(), sorted.end(), min, [] (Entry const &e, Geom::Coord v) { return e.first < v; });
+    auto const end = std::upper_bound(begin, sorted.end(), max, [] (Geom::Coord v, Entry const &e) { return v < e.first; });
+    return {begin, end};
+}
+
+std::vector<int> SnapCandidatePointIndex::query(Geom::Rect const &area) const
+{
+    // Scan whichever of the two coordinate ranges holds fewer targets, and filter by the other.
+    auto const rx = _range(Geom::X, area.left(), area.right());
+    auto const ry = _range(Geom::Y, area.top(), area.bottom());
+    bool const use_x = rx.second - rx.first <= ry.second - ry.first;
+    auto const [begin, end] = use_x ? rx : ry;
+
+    std::vector<int> result;
+    for (auto it = begin; it != end; ++it) {
+        if (area.contains(_points[it->second])) {
+            result.emplace_back(it->second);
+        }
+    }
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+std::vector<int> SnapCandidatePointIndex::queryBand(Geom::Dim2 d, Geom::Coord min, Geom::Coord max) const
+{
+    auto const [begin, end] = _range(d, min, max);
+
+    std::vector<int> result;
+    result.reserve(end - begin);
+    for (auto it = begin; it != end; ++it) {
+        result.emplace_back(it->second);
+    }
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+void SnapCandidatePathIndex::build(std::vector<SnapCandidatePath> const &paths)
+{
+    clear();
+
+    for (int i = 0; i < paths.size(); i++) {
+        auto const &pathv = paths[i].path_vector;
+        for (int j = 0; j < pathv.size(); j++) {
+            for (int k = 0; k < pathv[j].size(); k++) {
+                _segments.push_back({ i, j, k });
+                _bounds.emplace_back(pathv[j][k].boundsFast());
+            }
+        }
+    }
+
+    _order.resize(_segments.size());
+    std::iota(_order.begin(), _order.end(), 0);
+
+    if (!_segments.empty()) {
+        _build(0, _segments.size());
+    }
+
+    _built = true;
+}
+
+void SnapCandidatePathIndex::clear()
+{
+    _segments.clear();
+    _bounds.clear();
+    _order.clear();
+    _nodes.clear();
+    _built = false;
+}
+
+int SnapCandidatePathIndex::_build(int begin, int end)
+{
+    constexpr int leaf_size = 8;
+
+    Geom::Rect bounds = _bounds[_order[begin]];
+    for (int i = begin + 1; i < end; i++) {
+        bounds.unionWith(_bounds[_order[i]]);
+    }
+
+    int const index = _nodes.size();
+    _nodes.push_back({ bounds, begin, end });
+
+    if (end - begin > leaf_size) {
+        // Split at the median along the longer side
+        auto const d = bounds.width() >= bounds.height() ? Geom::X : Geom::Y;
+        int const mid = (begin + end) / 2;
+        std::nth_element(_order.begin() + begin, _order.begin() + mid, _order.begin() + end, [&, d] (int a, int b) {
+            return _bounds[a].midpoint()[d] < _bounds[b].midpoint()[d];
+        });
+        int const left = _build(begin, mid);
+        int const right = _build(mid, end);
+        _nodes[index].left = left;
+        _nodes[index].right = right;
+    }
+
+    return index;
+}
+
+template <typename F>
+std::vector<SnapCandidatePathIndex::Segment> SnapCandidatePathIndex::_query(F const &overlaps) const
+{
+    std::vector<int> found;
+
+    if (!_nodes.empty()) {
+        std::vector<int> stack = { 0 };
+        while (!stack.empty()) {
+            auto const &node = _nodes[stack.back()];
+            stack.pop_back();
+
+            if (!overlaps(node.bounds)) {
+                continue;
+            }
+
+            if (node.left < 0) {
+                for (int i = node.begin; i < node.end; i++) {
+                    if (overlaps(_bounds[_order[i]])) {
+                        found.emplace_back(_order[i]);
+                    }
+                }
+            } else {
+                stack.emplace_back(node.left);
+                stack.emplace_back(node.right);
+            }
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+
+    std::vector<Segment> result;
+    result.reserve(found.size());
+    for (auto i : found) {
+        result.emplace_back(_segments[i]);
+    }
+
+    return result;
+}
+
+std::vector<SnapCandidatePathIndex::Segment> SnapCandidatePathIndex::query(Geom::Point const &pt, Geom::Coord distance) const
+{
+    return _query([&] (Geom::Rect const &rect) {
+        auto const dx = std::max({ rect.left() - pt.x(), pt.x() - rect.right(), 0.0 });
+        auto const dy = std::max({ rect.top() - pt.y(), pt.y() - rect.bottom(), 0.0 });
+        return dx * dx + dy * dy < distance * distance;
+    });
+}
+
+std::vector<SnapCandidatePathIndex::Segment> SnapCandidatePathIndex::query(Geom::Rect const &area) const
+{
+    return _query([&] (Geom::Rect const &rect) {
+        return rect.intersects(area);
+    });
+}
+
+} // namespace Inkscape
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
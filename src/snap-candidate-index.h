@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#ifndef SEEN_SNAP_CANDIDATE_INDEX_H
+#define SEEN_SNAP_CANDIDATE_INDEX_H
+
+/**
+ * @file
+ * Spatial lookup of snap target points and paths.
+ */
+/*
+ * Copyright (C) 2025 Authors
+ *
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include <utility>
+#include <vector>
+#include <2geom/path.h>
+#include <2geom/point.h>
+#include <2geom/rect.h>
+
+#include "snap-candidate.h"
+
+namespace Inkscape {
+
+/**
+ * Index over a collection of snap targets, so that only the targets near the snap source have
+ * to be looked at. The targets are kept sorted by each coordinate; queries look up the matching
+ * range in one of them and return positions into the original collection, in increasing order,
+ * so that callers see the targets in the same order as a plain scan would.
+ *
+ * The index is built once for the first point of a snap and reused for all further points.
+ */
+class SnapCandidatePointIndex
+{
+public:
+    void build(std::vector<SnapCandidatePoint> const &points);
+    void clear();
+    bool built() const { return _built; }
+
+    /// Positions of the targets inside the rectangle.
+    std::vector<int> query(Geom::Rect const &area) const;
+
+    /// Positions of the targets whose coordinate in the given dimension lies in [min, max].
+    std::vector<int> queryBand(Geom::Dim2 d, Geom::Coord min, Geom::Coord max) const;
+
+private:
+    using Entry = std::pair<Geom::Coord, int>;
+    std::pair<std::vector<Entry>::const_iterator, std::vector<Entry>::const_iterator> _range(Geom::Dim2 d, Geom::Coord min, Geom::Coord max) const;
+
+    std::vector<Geom::Point> _points;
+    std::vector<Entry> _sorted[2];
+    bool _built = false;
+};
+
+/**
+ * Bounding volume hierarchy over the individual curves of a collection of snap target paths, so
+ * that nearest point and intersection searches only have to look at the curves near the snap
+ * source. Like SnapCandidatePointIndex, queries report the curves in collection order.
+ */
+class SnapCandidatePathIndex
+{
+public:
+    struct Segment
+    {
+        int path;    ///< Index of the SnapCandidatePath in the collection
+        int subpath; ///< Index of the path within its path vector
+        int curve;   ///< Index of the curve within its path
+    };
+
+    void build(std::vector<SnapCandidatePath> const &paths);
+    void clear();
+    bool built() const { return _built; }
+
+    /// Curves whose bounds come closer than the given distance to the point.
+    std::vector<Segment> query(Geom::Point const &pt, Geom::Coord distance) const;
+
+    /// Curves whose bounds intersect the rectangle.
+    std::vector<Segment> query(Geom::Rect const &area) const;
+
+private:
+    struct Node
+    {
+        Geom::Rect bounds;
+        int begin;
+        int end;
+        int left = -1;
+        int right = -1;
+    };
+
+    int _build(int begin, int end);
+
+    template <typename F>
+    std::vector<Segment> _query(F const &overlaps) const;
+
+    std::vector<Segment> _segments;
+    std::vector<Geom::Rect> _bounds;
+    std::vector<int> _order; ///< Segments ordered such that each node covers a contiguous range
+    std::vector<Node> _nodes;
+    bool _built = false;
+};
+
+} // namespace Inkscape
+
+#endif // SEEN_SNAP_CANDIDATE_INDEX_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -10,9 +10,49 @@
  */
 
 #include "snapped-curve.h"
+#include <2geom/bezier-curve.h>
 #include <2geom/path-intersection.h>
 
-Inkscape::SnappedCurve::SnappedCurve(Geom::Point const &snapped_point, Geom::Point const &tangent, int num_path, int num_segm, Geom::Coord const &snapped_distance, Geom::Coord const &snapped_tolerance, bool const &always_snap, bool const &fully_constrained, Geom::Curve const *curve, SnapSourceType source, long source_num, SnapTargetType target, Geom::OptRect target_bbox)
+namespace {
+
+// Append the order and control points of a Bezier curve to a cache key
+bool append_key(std::vector<Geom::Coord> &key, Geom::Curve const &curve)
+{
+    auto bezier = dynamic_cast<Geom::BezierCurve const *>(&curve);
+    if (!bezier) {
+        return false;
+    }
+    key.push_back(bezier->order());
+    for (auto const &pt : bezier->controlPoints()) {
+        key.push_back(pt[Geom::X]);
+        key.push_back(pt[Geom::Y]);
+    }
+    return true;
+}
+
+// Stop a long drag over many targets from piling up crossings without bound
+constexpr std::size_t CROSSINGS_CACHE_MAX_PAIRS = 4096;
+
+} // namespace
+
+Geom::Crossings Inkscape::CurveCrossingsCache::get(Geom::Curve const &a, Geom::Curve const &b)
+{
+    std::vector<Geom::Coord> key;
+    if (!append_key(key, a) || !append_key(key, b)) {
+        return crossings(a, b);
+    }
+
+    if (auto it = _crossings.find(key); it != _crossings.end()) {
+        return it->second;
+    }
+
+    if (_crossings.size() >= CROSSINGS_CACHE_MAX_PAIRS) {
+        _crossings.clear();
+    }
+    return _crossings.emplace(std::move(key), crossings(a, b)).first->second;
+}
+
+Inkscape::SnappedCurve::SnappedCurve(Geom::Point const &snapped_point, Geom::Point const &tangent, int num_path, int num_segm, Geom::Coord const &snapped_distance, Geom::Coord const &snapped_tolerance, bool const &always_snap, bool const &fully_constrained, Geom::Curve const *curve, SnapSourceType source, long source_num, SnapTargetType target, Geom::OptRect target_bbox, CurveCrossingsCache *crossings_cache)
 {
     _num_path = num_path;
     _num_segm = num_segm;
@@ -31,6 +71,7 @@ Inkscape::SnappedCurve::SnappedCurve(Geom::Point const &snapped_point, Geom::Poi
     _source_num = source_num;
     _target = target;
     _target_bbox = target_bbox;
+    _crossings_cache = crossings_cache;
 }
 
 Inkscape::SnappedCurve::SnappedCurve()
@@ -52,6 +93,7 @@ Inkscape::SnappedCurve::SnappedCurve()
     _source_num = -1;
     _target = SNAPTARGET_UNDEFINED;
     _target_bbox = Geom::OptRect();
+    _crossings_cache = nullptr;
 }
 
 Inkscape::SnappedCurve::~SnappedCurve()
@@ -64,7 +106,9 @@ Inkscape::SnappedPoint Inkscape::SnappedCurve::intersect(SnappedCurve const &cur
     // The point of intersection should be considered for snapping, but might be outside the snapping range
     // PS: We need p (the location of the mouse pointer) to find out which intersection is the
     // closest, as there might be multiple intersections of two curves
-    Geom::Crossings cs = crossings(*(this->_curve), *(curve._curve));
+    // The same pairs of target curves come up on every motion event of a drag, so reuse their crossings
+    Geom::Crossings cs = _crossings_cache ? _crossings_cache->get(*(this->_curve), *(curve._curve))
+                                          : crossings(*(this->_curve), *(curve._curve));
 
     if (cs.size() > 0) {
         // There might be multiple intersections: find the closest
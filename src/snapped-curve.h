@@ -12,7 +12,9 @@
  *    Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <2geom/crossing.h>
 #include <2geom/forward.h>
+#include <map>
 #include <vector>
 #include <list>
 
@@ -21,12 +23,30 @@
 
 namespace Inkscape {
 
+/**
+ * Crossings of pairs of snap target curves, kept by a snapper across snap calls.
+ *
+ * Bezier curves are keyed on their control points rather than on their address, so the crossings
+ * outlive each collection of snap targets, and a curve that has been edited in the meantime never
+ * picks up the crossings of its old shape. Other curves are always intersected afresh.
+ */
+class CurveCrossingsCache
+{
+public:
+    /// Crossings of a with b, in the order crossings(a, b) would return them.
+    Geom::Crossings get(Geom::Curve const &a, Geom::Curve const &b);
+    void clear() { _crossings.clear(); }
+
+private:
+    std::map<std::vector<Geom::Coord>, Geom::Crossings> _crossings;
+};
+
 /// Class describing the result of an attempt to snap to a curve.
 class SnappedCurve : public SnappedPoint
 {
 public:
     SnappedCurve();
-    SnappedCurve(Geom::Point const &snapped_point, Geom::Point const &tangent, int num_path, int num_segm, Geom::Coord const &snapped_distance, Geom::Coord const &snapped_tolerance, bool const &always_snap, bool const &fully_constrained, Geom::Curve const *curve, SnapSourceType source, long source_num, SnapTargetType target, Geom::OptRect target_bbox);
+    SnappedCurve(Geom::Point const &snapped_point, Geom::Point const &tangent, int num_path, int num_segm, Geom::Coord const &snapped_distance, Geom::Coord const &snapped_tolerance, bool const &always_snap, bool const &fully_constrained, Geom::Curve const *curve, SnapSourceType source, long source_num, SnapTargetType target, Geom::OptRect target_bbox, CurveCrossingsCache *crossings_cache = nullptr);
     ~SnappedCurve();
     Inkscape::SnappedPoint intersect(SnappedCurve const &curve, Geom::Point const &p, Geom::Affine dt2doc) const; //intersect with another SnappedCurve
     Inkscape::SnappedPoint intersect(SnappedLine const &line, Geom::Point const &p, Geom::Affine dt2doc) const; //intersect with a SnappedLine
@@ -35,6 +55,7 @@ private:
     Geom::Curve const *_curve;
     int _num_path;  // Unique id of the path to which this segment belongs too
     int _num_segm;  // Sequence number of this segment in the path
+    CurveCrossingsCache *_crossings_cache; // Owned by the snapper that found this curve, if any
 };
 
 }
@@ -160,8 +160,7 @@ void PathString::State::appendRelative(Geom::Coord v, Geom::Coord r) {
 }
 
 void PathString::State::appendNumber(double v, int precision, int minexp) {
-
-    str.append(sp_svg_number_write_de(v, precision, minexp));
+    sp_svg_number_append_de(str, v, precision, minexp);
 }
 
 void PathString::State::appendNumber(double v, double &rv) {
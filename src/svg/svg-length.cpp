@@ -11,8 +11,10 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <charconv>
 #include <cmath>
 #include <cstring>
+#include <optional>
 #include <string>
 #include <glib.h>
 #include <iostream>
@@ -31,51 +33,79 @@ static unsigned sp_svg_length_read_lff(gchar const *str, SVGLength::Unit *unit,
 # define MAX(a,b) ((a < b) ? (b) : (a))
 #endif
 
-unsigned int sp_svg_number_read_f(gchar const *str, float *val)
+namespace {
+
+/*
+ * Parse a number in the common form [+-]digits[.digits][e[+-]digits] using the correctly-rounded
+ * std::from_chars, which gives the same result as strtod without its locale handling. Anything
+ * else, such as leading whitespace, hexadecimal, infinities or out of range values, is left to
+ * g_ascii_strtod.
+ */
+bool read_number_fast(char const *str, double &val, char const *&end)
 {
-    if (!str) {
-        return 0;
+#if __cpp_lib_to_chars >= 201611L
+    auto p = str;
+    if (*p == '+' || *p == '-') {
+        p++;
+    }
+    if (!g_ascii_isdigit(*p) && *p != '.') {
+        return false;
     }
 
-    char *e;
-    float const v = g_ascii_strtod(str, &e);
-    if ((gchar const *) e == str) {
-        return 0;
+    auto const [ptr, ec] = std::from_chars(*str == '+' ? p : str, p + std::strlen(p), val);
+    if (ec != std::errc{} || *ptr == 'x' || *ptr == 'X') {
+        return false;
     }
 
-    *val = v;
-    return 1;
+    end = ptr;
+    return true;
+#else
+    return false;
+#endif
 }
 
-unsigned int sp_svg_number_read_d(gchar const *str, double *val)
+double read_number(char const *str, char const *&end)
 {
-    if (!str) {
-        return 0;
-    }
-
-    char *e;
-    double const v = g_ascii_strtod(str, &e);
-    if ((gchar const *) e == str) {
-        return 0;
+    double v;
+    if (!read_number_fast(str, v, end)) {
+        char *e;
+        v = g_ascii_strtod(str, &e);
+        end = e;
     }
+    return v;
+}
 
-    *val = v;
-    return 1;
+void append_uint(std::string &buf, unsigned int val)
+{
+    char digits[16];
+    auto const [ptr, ec] = std::to_chars(digits, digits + sizeof(digits), val);
+    buf.append(digits, ptr);
 }
 
-static std::string sp_svg_number_write_d( double val, unsigned int tprec, unsigned int fprec)
+void append_int(std::string &buf, int val)
 {
+    char digits[16];
+    auto const [ptr, ec] = std::to_chars(digits, digits + sizeof(digits), val);
+    buf.append(digits, ptr);
+}
 
-    std::string buf;
+/*
+ * Append val rounded to tprec significant digits, but at least fprec fractional digits, without
+ * trailing zeros. The number of integral digits is passed in if the caller already knows it.
+ */
+void append_number_d(std::string &buf, double val, unsigned int tprec, unsigned int fprec, std::optional<int> idigits_known = {})
+{
     /* Process sign */
     if (val < 0.0) {
-        buf.append("-");
+        buf += '-';
         val = fabs(val);
     }
 
     /* Determine number of integral digits */
     int idigits = 0;
-    if (val >= 1.0) {
+    if (idigits_known) {
+        idigits = *idigits_known;
+    } else if (val >= 1.0) {
         idigits = (int) floor(log10(val)) + 1;
     }
 
@@ -86,41 +116,74 @@ static std::string sp_svg_number_write_d( double val, unsigned int tprec, unsign
     /* Extract integral and fractional parts */
     double dival = floor(val);
     double fval = val - dival;
-    /* Write integra */
+    /* Write integral part */
     if (idigits > (int)tprec) {
-        buf.append(std::to_string((unsigned int)floor(dival/pow(10.0, idigits-tprec) + .5)));
-        for(unsigned int j=0; j<(unsigned int)idigits-tprec; j++) {
-            buf.append("0");
-        }
+        append_uint(buf, (unsigned int)floor(dival/pow(10.0, idigits-tprec) + .5));
+        buf.append(idigits - tprec, '0');
     } else {
-       buf.append(std::to_string((unsigned int)dival));
+        append_uint(buf, (unsigned int)dival);
     }
 
+    /* Write fractional part, dropping the trailing zeros */
     if (fprec > 0 && fval > 0.0) {
-        std::string s(".");
+        auto const point = buf.size();
+        auto significant = point;
+        buf += '.';
         do {
             fval *= 10.0;
             dival = floor(fval);
             fval -= dival;
             int const int_dival = (int) dival;
-            s.append(std::to_string(int_dival));
-            if(int_dival != 0){
-                buf.append(s);
-                s="";
+            append_int(buf, int_dival);
+            if (int_dival != 0) {
+                significant = buf.size();
             }
             fprec -= 1;
-        } while(fprec > 0 && fval > 0.0);
+        } while (fprec > 0 && fval > 0.0);
+        buf.resize(significant);
     }
-    return buf;
 }
 
-std::string sp_svg_number_write_de(double val, unsigned int tprec, int min_exp)
+} // namespace
+
+unsigned int sp_svg_number_read_f(gchar const *str, float *val)
+{
+    if (!str) {
+        return 0;
+    }
+
+    char const *e;
+    float const v = read_number(str, e);
+    if (e == str) {
+        return 0;
+    }
+
+    *val = v;
+    return 1;
+}
+
+unsigned int sp_svg_number_read_d(gchar const *str, double *val)
+{
+    if (!str) {
+        return 0;
+    }
+
+    char const *e;
+    double const v = read_number(str, e);
+    if (e == str) {
+        return 0;
+    }
+
+    *val = v;
+    return 1;
+}
+
+void sp_svg_number_append_de(std::string &buf, double val, unsigned int tprec, int min_exp)
 {
-    std::string buf;
     int eval = (int)floor(log10(fabs(val)));
     if (val == 0.0 || eval < min_exp) {
-        buf.append("0");
-        return buf;
+        buf += '0';
+        return;
     }
     unsigned int maxnumdigitsWithoutExp = // This doesn't include the sign because it is included in either representation
         eval<0?tprec+(unsigned int)-eval+1:
@@ -128,15 +191,20 @@ std::string sp_svg_number_write_de(double val, unsigned int tprec, int min_exp)
         (unsigned int)eval+1;
     unsigned int maxnumdigitsWithExp = tprec + ( eval<0 ? 4 : 3 ); // It's not necessary to take larger exponents into account, because then maxnumdigitsWithoutExp is DEFINITELY larger
     if (maxnumdigitsWithoutExp <= maxnumdigitsWithExp) {
-        buf.append(sp_svg_number_write_d(val, tprec, 0));
+        append_number_d(buf, val, tprec, 0, eval < 0 ? 0 : eval + 1);
     } else {
         val = eval < 0 ? val * pow(10.0, -eval) : val / pow(10.0, eval);
-        buf.append(sp_svg_number_write_d(val, tprec, 0));
-        buf.append("e");
-        buf.append(std::to_string(eval));
+        append_number_d(buf, val, tprec, 0);
+        buf += 'e';
+        append_int(buf, eval);
     }
-    return buf;
+}
 
+std::string sp_svg_number_write_de(double val, unsigned int tprec, int min_exp)
+{
+    std::string buf;
+    sp_svg_number_append_de(buf, val, tprec, min_exp);
+    return buf;
 }
 
 SVGLength::SVGLength()
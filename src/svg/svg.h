@@ -36,6 +36,7 @@ unsigned int sp_svg_number_read_d( const char *str, double *val );
  * No buffer overflow checking is done, so better wrap them if needed
  */
 std::string sp_svg_number_write_de( double val, unsigned int tprec, int min_exp );
+void sp_svg_number_append_de( std::string &buf, double val, unsigned int tprec, int min_exp );
 
 /* Length */
 
@@ -14,13 +14,25 @@
  * is provided by the generosity of Peter Selinger, to whom we are grateful.
  *
  */
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
 #include <potracelib.h>
+#include <2geom/pathvector.h>
+#include <2geom/transforms.h>
 
 #include "inkscape-potrace.h"
 #include "bitmap.h"
 
 #include "async/progress.h"
+#include "async/progress-splitter.h"
+#include "display/dispatch-pool.h"
+#include "display/threading.h"
+#include "path/path-boolop.h"
 #include "trace/filterset.h"
 #include "trace/quantize.h"
 #include "trace/imagemap-gdk.h"
@@ -39,6 +51,161 @@ Glib::ustring twohex(int value)
     return Inkscape::ustring::format_classic(std::hex, std::setfill('0'), std::setw(2), value);
 }
 
+/**
+ * The pool traces run on, sized like the global dispatch pool. Tracing dispatches jobs that take seconds, and
+ * dispatch_pool runs one dispatch at a time, so it has a pool of its own rather than holding up the canvas
+ * filters that share the global one.
+ */
+std::shared_ptr<Inkscape::dispatch_pool> get_trace_pool()
+{
+    static std::mutex mutex;
+    static std::shared_ptr<Inkscape::dispatch_pool> pool;
+
+    int const size = Inkscape::get_global_dispatch_pool()->size();
+
+    std::scoped_lock lock(mutex);
+    if (!pool || pool->size() != size) {
+        pool = std::make_shared<Inkscape::dispatch_pool>(size);
+    }
+    return pool;
+}
+
+/**
+ * Run \a count independent scans of a multi-scan trace, each with an equal share of \a progress.
+ *
+ * If \a parallel, the scans are run a batch at a time on the trace pool, and \a scan is passed no progress.
+ * Otherwise they are run one after the other on this thread, and \a scan is passed its share.
+ */
+template <typename F>
+void run_scans(int count, bool parallel, Inkscape::Async::Progress<double> &progress, F const &scan)
+{
+    std::vector<std::optional<Inkscape::Async::SubProgress<double>>> subprogress(count);
+    {
+        auto splitter = Inkscape::Async::ProgressSplitter(progress);
+        for (auto &sub : subprogress) {
+            splitter.add(sub, 1.0);
+        }
+    }
+
+    if (!parallel) {
+        for (int i = 0; i < count; i++) {
+            scan(i, &*subprogress[i]);
+            subprogress[i]->report_or_throw(1.0);
+        }
+        return;
+    }
+
+    auto const pool = get_trace_pool();
+    int const batch_size = pool->size();
+
+    for (int batch = 0; batch < count; batch += batch_size) {
+        int const n = std::min(batch_size, count - batch);
+        pool->dispatch(n, [&] (int i, int) {
+            scan(batch + i, nullptr);
+        });
+        for (int i = batch; i < batch + n; i++) {
+            subprogress[i]->report_or_throw(1.0);
+        }
+    }
+}
+
+// How far a vertex may lie from a seam and still count as being on it, allowing for the rounding of the clip.
+double constexpr SEAM_EPSILON = 0.01;
+
+/**
+ * Moves the points where a band crosses one of its seams onto the points agreed with the neighbouring band.
+ * Each entry maps the x coordinate of a crossing to the x coordinate it is moved to; both are sorted by the first.
+ */
+using SeamMap = std::vector<std::pair<double, double>>;
+
+/**
+ * The sorted x coordinates of the vertices of \a pathv that lie on the horizontal line at \a y.
+ */
+std::vector<double> seam_crossings(Geom::PathVector const &pathv, double y)
+{
+    std::vector<double> xs;
+    for (auto const &path : pathv) {
+        for (auto const &curve : path) {
+            for (auto const &p : {curve.initialPoint(), curve.finalPoint()}) {
+                if (std::abs(p.y() - y) < SEAM_EPSILON) {
+                    xs.push_back(p.x());
+                }
+            }
+        }
+    }
+
+    std::sort(xs.begin(), xs.end());
+    xs.erase(std::unique(xs.begin(), xs.end(), [] (double a, double b) { return b - a < SEAM_EPSILON; }), xs.end());
+    return xs;
+}
+
+/**
+ * Pair up the crossings of a seam by the bands above and below it, each with the nearest crossing on the other side
+ * that is at most a pixel away, and send both to their midpoint. Crossings left without a partner stay where they are.
+ */
+std::pair<SeamMap, SeamMap> match_seam(std::vector<double> const &above, std::vector<double> const &below)
+{
+    std::pair<SeamMap, SeamMap> result;
+
+    std::size_t i = 0, j = 0;
+    while (i < above.size() && j < below.size()) {
+        if (std::abs(above[i] - below[j]) <= 1.0) {
+            double const mid = (above[i] + below[j]) / 2;
+            result.first.emplace_back(above[i++], mid);
+            result.second.emplace_back(below[j++], mid);
+        } else if (above[i] < below[j]) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Where \a map sends the crossing at \a x.
+ */
+double apply_seam(SeamMap const &map, double x)
+{
+    auto it = std::lower_bound(map.begin(), map.end(), x - SEAM_EPSILON, [] (auto const &entry, double v) { return entry.first < v; });
+    if (it != map.end() && std::abs(it->first - x) < SEAM_EPSILON) {
+        return it->second;
+    }
+    return x;
+}
+
+/**
+ * Move the vertices of a band that lie on its top seam \a y0 or bottom seam \a y1 as given by the seam maps.
+ * Vertices anywhere else are left as they are, and so are the curves between them, apart from their end points.
+ */
+Geom::PathVector stitch_band(Geom::PathVector const &pathv, double y0, SeamMap const *top, double y1, SeamMap const *bottom)
+{
+    auto const move = [&] (Geom::Point const &p) {
+        if (top && std::abs(p.y() - y0) < SEAM_EPSILON) {
+            return Geom::Point(apply_seam(*top, p.x()), y0);
+        }
+        if (bottom && std::abs(p.y() - y1) < SEAM_EPSILON) {
+            return Geom::Point(apply_seam(*bottom, p.x()), y1);
+        }
+        return p;
+    };
+
+    Geom::PathVector result;
+    for (auto const &path : pathv) {
+        auto stitched = Geom::Path(move(path.initialPoint()));
+        for (auto const &curve : path) {
+            auto moved = std::unique_ptr<Geom::Curve>(curve.duplicate());
+            moved->setInitial(move(curve.initialPoint()));
+            moved->setFinal(move(curve.finalPoint()));
+            stitched.append(moved.release());
+        }
+        stitched.close(path.closed());
+        result.push_back(std::move(stitched));
+    }
+    return result;
+}
+
 } // namespace
 
 namespace Inkscape {
@@ -154,18 +321,7 @@ std::optional<GrayMap> PotraceTracingEngine::filter(Glib::RefPtr<Gdk::Pixbuf> co
     } else if (traceType == TraceType::BRIGHTNESS || traceType == TraceType::BRIGHTNESS_MULTI) {
 
         // Brightness threshold
-        auto gm = gdkPixbufToGrayMap(pixbuf);
-        map = GrayMap(gm.width, gm.height);
-
-        double floor = 3.0 * brightnessFloor * 256.0;
-        double cutoff = 3.0 * brightnessThreshold * 256.0;
-        for (int y = 0; y < gm.height; y++) {
-            for (int x = 0; x < gm.width; x++) {
-                double brightness = gm.getPixel(x, y);
-                bool black = brightness >= floor && brightness < cutoff;
-                map->setPixel(x, y, black ? GrayMap::BLACK : GrayMap::WHITE);
-            }
-        }
+        map = brightnessBand(gdkPixbufToGrayMap(pixbuf), brightnessFloor, brightnessThreshold);
 
         // map->writePPM(map, "brightness.ppm");
 
@@ -180,18 +336,43 @@ std::optional<GrayMap> PotraceTracingEngine::filter(Glib::RefPtr<Gdk::Pixbuf> co
 
     // Invert the image if necessary.
     if (map && invert) {
-        for (int y = 0; y < map->height; y++) {
-            for (int x = 0; x < map->width; x++) {
-                auto brightness = map->getPixel(x, y);
-                brightness = GrayMap::WHITE - brightness;
-                map->setPixel(x, y, brightness);
-            }
+        invertGrayMap(*map);
+    }
+
+    return map;
+}
+
+/**
+ * Threshold a graymap of pixel brightnesses, making black those between \a floor and \a threshold.
+ */
+GrayMap PotraceTracingEngine::brightnessBand(GrayMap const &gm, double floor, double threshold)
+{
+    auto map = GrayMap(gm.width, gm.height);
+
+    double const low = 3.0 * floor * 256.0;
+    double const cutoff = 3.0 * threshold * 256.0;
+    for (int y = 0; y < gm.height; y++) {
+        for (int x = 0; x < gm.width; x++) {
+            double brightness = gm.getPixel(x, y);
+            bool black = brightness >= low && brightness < cutoff;
+            map.setPixel(x, y, black ? GrayMap::BLACK : GrayMap::WHITE);
         }
     }
 
     return map;
 }
 
+void PotraceTracingEngine::invertGrayMap(GrayMap &map)
+{
+    for (int y = 0; y < map.height; y++) {
+        for (int x = 0; x < map.width; x++) {
+            auto brightness = map.getPixel(x, y);
+            brightness = GrayMap::WHITE - brightness;
+            map.setPixel(x, y, brightness);
+        }
+    }
+}
+
 IndexedMap PotraceTracingEngine::filterIndexed(Glib::RefPtr<Gdk::Pixbuf> const &pixbuf) const
 {
     auto map = gdkPixbufToRgbMap(pixbuf);
@@ -239,11 +420,12 @@ Glib::RefPtr<Gdk::Pixbuf> PotraceTracingEngine::preview(Glib::RefPtr<Gdk::Pixbuf
 }
 
 /**
- * This is the actual wrapper of the call to Potrace.
+ * Trace rows \a y0 to \a y1 of a graymap with the given parameters, returning the paths in graymap coordinates.
+ * Returns nothing if the bitmap could not be allocated.
  */
-Geom::PathVector PotraceTracingEngine::grayMapToPath(GrayMap const &grayMap, Async::Progress<double> &progress)
+std::optional<Geom::PathVector> PotraceTracingEngine::traceRows(GrayMap const &grayMap, int y0, int y1, potrace_param_t *params, Async::Progress<double> &progress) const
 {
-    auto potraceBitmap = potrace_bitmap_uniqptr(bm_new(grayMap.width, grayMap.height));
+    auto potraceBitmap = potrace_bitmap_uniqptr(bm_new(grayMap.width, y1 - y0));
     if (!potraceBitmap) {
         return {};
     }
@@ -251,9 +433,9 @@ Geom::PathVector PotraceTracingEngine::grayMapToPath(GrayMap const &grayMap, Asy
     bm_clear(potraceBitmap.get(), 0);
 
     // Read the data out of the GrayMap
-    for (int y = 0; y < grayMap.height; y++) {
+    for (int y = y0; y < y1; y++) {
         for (int x = 0; x < grayMap.width; x++) {
-            BM_UPUT(potraceBitmap, x, y, grayMap.getPixel(x, y) ? 0 : 1);
+            BM_UPUT(potraceBitmap, x, y - y0, grayMap.getPixel(x, y) ? 0 : 1);
         }
     }
 
@@ -267,12 +449,7 @@ Geom::PathVector PotraceTracingEngine::grayMapToPath(GrayMap const &grayMap, Asy
     */
 
     // Trace the bitmap.
-
-    auto throttled = Async::ProgressStepThrottler(progress, 0.02);
-
-    potraceParams->progress.data = &throttled;
-    potraceParams->progress.callback = [] (double progress, void *data) { reinterpret_cast<decltype(throttled)*>(data)->report(progress); };
-    auto potraceState = potrace_state_uniqptr(potrace_trace(potraceParams, potraceBitmap.get()));
+    auto potraceState = potrace_state_uniqptr(potrace_trace(params, potraceBitmap.get()));
 
     potraceBitmap.reset();
 
@@ -282,7 +459,129 @@ Geom::PathVector PotraceTracingEngine::grayMapToPath(GrayMap const &grayMap, Asy
     Geom::PathBuilder builder;
     std::unordered_set<Geom::Point> points;
     writePaths(potraceState->plist, builder, points, progress);
-    return builder.peek();
+
+    auto result = builder.peek();
+    if (y0 != 0) {
+        result *= Geom::Translate(0, y0);
+    }
+    return result;
+}
+
+/**
+ * This is the actual wrapper of the call to Potrace.
+ */
+Geom::PathVector PotraceTracingEngine::grayMapToPath(GrayMap const &grayMap, Async::Progress<double> &progress)
+{
+    if ((long)grayMap.width * grayMap.height > TILED_MIN_PIXELS) {
+        return grayMapToPathTiled(grayMap, progress);
+    }
+
+    auto throttled = Async::ProgressStepThrottler(progress, 0.02);
+
+    potraceParams->progress.data = &throttled;
+    potraceParams->progress.callback = [] (double progress, void *data) { reinterpret_cast<decltype(throttled)*>(data)->report(progress); };
+
+    return traceRows(grayMap, 0, grayMap.height, potraceParams, progress).value_or(Geom::PathVector());
+}
+
+/**
+ * Trace a graymap from a thread of the trace pool. Progress is not reported and potraceParams is left untouched,
+ * so several of these can run at once.
+ */
+Geom::PathVector PotraceTracingEngine::grayMapToPathConcurrent(GrayMap const &grayMap) const
+{
+    auto params = *potraceParams;
+    params.progress.callback = nullptr;
+    params.progress.data = nullptr;
+
+    auto always = Async::ProgressAlways<double>();
+    return traceRows(grayMap, 0, grayMap.height, &params, always).value_or(Geom::PathVector());
+}
+
+/**
+ * Trace a large graymap in horizontal bands, in parallel, and stitch the results back together.
+ *
+ * Each band is traced together with a few rows of its neighbours, and the result is clipped back to the band,
+ * so that the rounding potrace applies at the edges of a bitmap never shows in the part that is kept. Each band
+ * still fits its own curves, so where an outline crosses a seam the two clipped pieces end a fraction of a pixel
+ * apart. Those end points are matched up across the seam and moved to a common point before a union joins the
+ * pieces into whole paths again. Only the bitmaps and traces of the bands in flight are held in memory at any time.
+ */
+Geom::PathVector PotraceTracingEngine::grayMapToPathTiled(GrayMap const &grayMap, Async::Progress<double> &progress)
+{
+    int const band_height = std::max(BAND_PIXELS / grayMap.width, 4 * BAND_OVERLAP);
+    int const band_count = (grayMap.height + band_height - 1) / band_height;
+
+    std::vector<Geom::PathVector> bands(band_count);
+
+    auto const pool = get_trace_pool();
+    int const batch_size = pool->size();
+
+    // Trace the bands a batch at a time, so that cancellation is noticed and progress reported in between.
+    for (int batch = 0; batch < band_count; batch += batch_size) {
+        int const count = std::min(batch_size, band_count - batch);
+
+        pool->dispatch(count, [&] (int i, int) {
+            int const band = batch + i;
+            int const y0 = band * band_height;
+            int const y1 = std::min(y0 + band_height, grayMap.height);
+
+            // Each thread gets its own copy of the parameters, without the progress callback.
+            auto params = *potraceParams;
+            params.progress.callback = nullptr;
+            params.progress.data = nullptr;
+
+            auto always = Async::ProgressAlways<double>();
+            auto traced = traceRows(grayMap, std::max(y0 - BAND_OVERLAP, 0), std::min(y1 + BAND_OVERLAP, grayMap.height), &params, always);
+            if (!traced || traced->empty()) {
+                return;
+            }
+
+            // Clip back to the band, leaving the outer edges of the image alone.
+            auto const clip = Geom::Rect(-1, band == 0 ? -1 : y0, grayMap.width + 1, band == band_count - 1 ? grayMap.height + 1 : y1);
+            bands[band] = sp_pathvector_boolop(Geom::PathVector(Geom::Path(clip)), *traced, bool_op_inters, fill_nonZero, fill_nonZero);
+        });
+
+        progress.report_or_throw(0.8 * (batch + count) / band_count);
+    }
+
+    // Agree on where the outlines cross each seam, then move the ends of the clipped pieces there.
+    std::vector<std::pair<SeamMap, SeamMap>> seams(band_count);
+    pool->dispatch(band_count - 1, [&] (int i, int) {
+        int const band = i + 1;
+        double const y = band * band_height;
+        seams[band] = match_seam(seam_crossings(bands[band - 1], y), seam_crossings(bands[band], y));
+    });
+
+    pool->dispatch(band_count, [&] (int band, int) {
+        if (bands[band].empty()) {
+            return;
+        }
+        auto const top = band == 0 ? nullptr : &seams[band].second;
+        auto const bottom = band == band_count - 1 ? nullptr : &seams[band + 1].first;
+        bands[band] = stitch_band(bands[band], band * band_height, top, (band + 1) * band_height, bottom);
+    });
+
+    // Stitch neighbouring bands together, pairwise, until a single path vector is left.
+    for (int step = 1; step < band_count; step *= 2) {
+        int const pairs = (band_count - 1) / (2 * step) + 1;
+        pool->dispatch(pairs, [&] (int k, int) {
+            int const i = 2 * step * k;
+            if (i + step >= band_count || bands[i + step].empty()) {
+                return;
+            }
+            if (bands[i].empty()) {
+                bands[i] = std::move(bands[i + step]);
+            } else {
+                bands[i] = sp_pathvector_boolop(bands[i], bands[i + step], bool_op_union, fill_nonZero, fill_nonZero);
+            }
+            bands[i + step].clear();
+        });
+
+        progress.report_or_throw(0.8 + 0.2 * std::min(2.0 * step / band_count, 1.0));
+    }
+
+    return std::move(bands[0]);
 }
 
 /**
@@ -328,40 +627,60 @@ TraceResult PotraceTracingEngine::traceBrightnessMulti(Glib::RefPtr<Gdk::Pixbuf>
     double constexpr high  = 0.9; // top of range
     double const     delta = (high - low) / multiScanNrColors;
 
-    brightnessFloor = 0.0; // Set bottom to black
-
-    TraceResult results;
+    auto const gm = gdkPixbufToGrayMap(pixbuf);
 
+    // Each scan covers the brightnesses from its floor to its threshold. Without stacking, the floor is the
+    // threshold of the previous scan that traced anything; assume for now that that is the one just before.
+    std::vector<double> thresholds(multiScanNrColors);
+    std::vector<double> floors(multiScanNrColors);
     for (int i = 0; i < multiScanNrColors; i++) {
-        auto subprogress = Async::SubProgress(progress, (double)i / multiScanNrColors, 1.0 / multiScanNrColors);
+        thresholds[i] = low + delta * i;
+        floors[i] = multiScanStack || i == 0 ? 0.0 : thresholds[i - 1];
+    }
 
-        brightnessThreshold = low + delta * i;
+    auto scan = [&, this] (int i, Async::Progress<double> *subprogress) {
+        auto grayMap = brightnessBand(gm, floors[i], thresholds[i]);
+        if (invert) {
+            invertGrayMap(grayMap);
+        }
+        return subprogress ? grayMapToPath(grayMap, *subprogress) : grayMapToPathConcurrent(grayMap);
+    };
 
-        auto grayMap = filter(pixbuf);
-        if (!grayMap) {
-            continue;
+    std::vector<Geom::PathVector> paths(multiScanNrColors);
+    bool const parallel = (long)gm.width * gm.height <= TILED_MIN_PIXELS;
+    run_scans(multiScanNrColors, parallel, progress, [&] (int i, Async::Progress<double> *subprogress) {
+        paths[i] = scan(i, subprogress);
+    });
+
+    // Redo the scans that follow one that traced nothing, as their floor is lower than assumed.
+    if (!multiScanStack) {
+        double floor = 0.0;
+        for (int i = 0; i < multiScanNrColors; i++) {
+            if (floors[i] != floor) {
+                progress.throw_if_cancelled();
+                auto always = Async::ProgressAlways<double>();
+                floors[i] = floor;
+                paths[i] = scan(i, &always);
+            }
+            if (!paths[i].empty()) {
+                floor = thresholds[i];
+            }
         }
+    }
 
-        subprogress.report_or_throw(0.2);
+    TraceResult results;
 
-        auto sub_gmtopath = Async::SubProgress(subprogress, 0.2, 0.8);
-        auto pv = grayMapToPath(*grayMap, sub_gmtopath);
-        if (pv.empty()) {
+    for (int i = 0; i < multiScanNrColors; i++) {
+        if (paths[i].empty()) {
             continue;
         }
 
         // get style info
-        int grayVal = 256.0 * brightnessThreshold;
+        int grayVal = 256.0 * thresholds[i];
         auto style = Glib::ustring::compose("fill-opacity:1.0;fill:#%1%2%3", twohex(grayVal), twohex(grayVal), twohex(grayVal));
 
         // g_message("### GOT '%s' \n", style.c_str());
-        results.emplace_back(style.raw(), std::move(pv));
-
-        if (!multiScanStack) {
-            brightnessFloor = brightnessThreshold;
-        }
-
-        subprogress.report_or_throw(1.0);
+        results.emplace_back(style.raw(), std::move(paths[i]));
     }
 
     // Remove the bottom-most scan, if requested.
@@ -379,45 +698,33 @@ TraceResult PotraceTracingEngine::traceQuant(Glib::RefPtr<Gdk::Pixbuf> const &pi
 {
     auto imap = filterIndexed(pixbuf);
 
-    // Create and clear a gray map
-    auto gm = GrayMap(imap.width, imap.height);
-    for (int row = 0; row < gm.height; row++) {
-        for (int col = 0; col < gm.width; col++) {
-            gm.setPixel(col, row, GrayMap::WHITE);
-        }
-    }
+    std::vector<Geom::PathVector> paths(imap.nrColors);
+    bool const parallel = (long)imap.width * imap.height <= TILED_MIN_PIXELS;
 
-    TraceResult results;
-
-    for (int colorIndex = 0; colorIndex < imap.nrColors; colorIndex++) {
-        auto subprogress = Async::SubProgress(progress, (double)colorIndex / imap.nrColors, 1.0 / imap.nrColors);
-
-        // Update the graymap for the current color index
+    run_scans(imap.nrColors, parallel, progress, [&, this] (int colorIndex, Async::Progress<double> *subprogress) {
+        // Make a graymap of the current color index; when stacking, of all the ones before it as well
+        auto gm = GrayMap(imap.width, imap.height);
         for (int row = 0; row < imap.height; row++) {
             for (int col = 0; col < imap.width; col++) {
                 int index = imap.getPixel(col, row);
-                if (index == colorIndex) {
-                    gm.setPixel(col, row, GrayMap::BLACK);
-                } else if (!multiScanStack) {
-                    gm.setPixel(col, row, GrayMap::WHITE);
-                }
+                bool black = multiScanStack ? index <= colorIndex : index == colorIndex;
+                gm.setPixel(col, row, black ? GrayMap::BLACK : GrayMap::WHITE);
             }
         }
 
-        subprogress.report_or_throw(0.2);
-
         // Now we have a traceable graymap
-        auto sub_gmtopath = Async::SubProgress(subprogress, 0.2, 0.8);
-        auto pv = grayMapToPath(gm, sub_gmtopath);
+        paths[colorIndex] = subprogress ? grayMapToPath(gm, *subprogress) : grayMapToPathConcurrent(gm);
+    });
 
-        if (!pv.empty()) {
+    TraceResult results;
+
+    for (int colorIndex = 0; colorIndex < imap.nrColors; colorIndex++) {
+        if (!paths[colorIndex].empty()) {
             // get style info
             auto rgb = imap.clut[colorIndex];
             auto style = Glib::ustring::compose("fill:#%1%2%3", twohex(rgb.r), twohex(rgb.g), twohex(rgb.b));
-            results.emplace_back(style.raw(), std::move(pv));
+            results.emplace_back(style.raw(), std::move(paths[colorIndex]));
         }
-
-        subprogress.report_or_throw(1.0);
     }
 
     // Remove the bottom-most scan, if requested.
@@ -104,8 +104,19 @@ private:
 
     IndexedMap filterIndexed(Glib::RefPtr<Gdk::Pixbuf> const &pixbuf) const;
     std::optional<GrayMap> filter(Glib::RefPtr<Gdk::Pixbuf> const &pixbuf) const;
+    static GrayMap brightnessBand(GrayMap const &gm, double floor, double threshold);
+    static void invertGrayMap(GrayMap &map);
+
+    // Graymaps with more pixels than this are traced in bands of roughly BAND_PIXELS pixels, in parallel.
+    static constexpr long TILED_MIN_PIXELS = 4096 * 1024;
+    static constexpr int BAND_PIXELS = 1024 * 1024;
+    // Rows of each neighbouring band traced along with a band.
+    static constexpr int BAND_OVERLAP = 16;
 
     Geom::PathVector grayMapToPath(GrayMap const &gm, Async::Progress<double> &progress);
+    Geom::PathVector grayMapToPathTiled(GrayMap const &gm, Async::Progress<double> &progress);
+    Geom::PathVector grayMapToPathConcurrent(GrayMap const &gm) const;
+    std::optional<Geom::PathVector> traceRows(GrayMap const &gm, int y0, int y1, potrace_param_t *params, Async::Progress<double> &progress) const;
 
     void writePaths(potrace_path_t *paths, Geom::PathBuilder &builder, std::unordered_set<Geom::Point> &points, Async::Progress<double> &progress) const;
 };
@@ -9,12 +9,17 @@
  *
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
+#include <algorithm>
 #include <memory>
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
+#include <vector>
 #include <glib.h>
 
 #include "pool.h"
+#include "display/dispatch-pool.h"
+#include "display/threading.h"
 #include "imagemap.h"
 #include "quantize.h"
 
@@ -34,10 +39,19 @@ struct Ocnode
     int nchild;               // number of children
     int width;                // width level of this node
     RGB rgb;                  // rgb's prefix of that node
-    unsigned long weight;     // number of pixels this node accounts for
-    unsigned long rs, gs, bs; // sum of pixels colors this node accounts for
+    std::uint64_t weight;     // number of pixels this node accounts for
+    std::uint64_t rs, gs, bs; // sum of pixels colors this node accounts for
     int nleaf;                // number of leaves under this node
-    unsigned long mi;         // minimum impact
+    std::uint64_t mi;         // minimum impact
+};
+
+/**
+ * a bin of the color histogram
+ */
+struct Bin
+{
+    std::uint64_t weight = 0;         // number of pixels in this bin
+    std::uint64_t rs = 0, gs = 0, bs = 0; // sum of their colors
 };
 
 /*
@@ -81,9 +95,10 @@ struct Ocnode
   - ranges have no intersection, and a fork node has to be created (like in
     the given example).
 
-- a tree for an image is built dividing the image in 2 parts and merging
-  the trees obtained recursively for the two parts. a tree for a one pixel
-  part is a leaf like one of those which were given above.
+- a tree for an image is built from its color histogram, dividing the set
+  of non-empty histogram bins in 2 parts and merging the trees obtained
+  recursively for the two parts. a tree for a single bin is a leaf like one
+  of those which were given above, whose prefix is the bin's color prefix.
 
 - last, this tree is reduced a specified number of leaves, deleting first
   leaves with minimal impact i.e. [ weight * 2^(2*parentwidth) ] value :
@@ -144,6 +159,16 @@ struct Ocnode
 - pool allocation is used to allocate nodes (increased performance on large
   images).
 
+- the tree is built from a histogram of the image with HIST_BITS bits per
+  component, so its size depends on the number of distinct colors rather
+  than on the number of pixels. bins keep the exact sums of their pixel
+  colors, so palette colors are unaffected by the binning. the histogram is
+  built in parallel, each thread binning its own part of the image.
+
+- pixels are remapped through an inverse color lookup table holding the
+  closest palette color for each LUT_BITS bits per component color prefix,
+  rather than by searching the palette for every pixel.
+
 */
 
 RGB operator>>(RGB rgb, int s)
@@ -230,17 +255,32 @@ void octreePrint(Ocnode *node)
 }
 #endif
 
+int constexpr HIST_BITS = 5;                    // bits per component kept by the histogram
+int constexpr HIST_SIZE = 1 << (3 * HIST_BITS);
+int constexpr LUT_BITS = 6;                     // bits per component of the inverse color lookup table
+int constexpr LUT_SIZE = 1 << (3 * LUT_BITS);
+std::size_t constexpr HIST_CHUNK_PIXELS = 1 << 18; // minimum number of pixels binned by one thread
+
+template <int BITS>
+int colorIndex(RGB rgb)
+{
+    return ((rgb.r >> (8 - BITS)) << (2 * BITS)) | ((rgb.g >> (8 - BITS)) << BITS) | (rgb.b >> (8 - BITS));
+}
+
 /**
- * builds a single <rgb> color leaf at location <ref>
+ * builds a single leaf for the histogram bin <index> at location <ref>
  */
-void ocnodeLeaf(Pool<Ocnode> &pool, Ocnode **ref, RGB rgb)
+void ocnodeLeaf(Pool<Ocnode> &pool, Ocnode **ref, int index, Bin const &bin)
 {
     assert(ref);
+    int constexpr mask = (1 << HIST_BITS) - 1;
     Ocnode *node = ocnodeNew(pool);
-    node->width = 0;
-    node->rgb = rgb;
-    node->rs = rgb.r; node->gs = rgb.g; node->bs = rgb.b;
-    node->weight = 1;
+    node->width = 8 - HIST_BITS;
+    node->rgb.r = (index >> (2 * HIST_BITS)) & mask;
+    node->rgb.g = (index >> HIST_BITS) & mask;
+    node->rgb.b = index & mask;
+    node->rs = bin.rs; node->gs = bin.gs; node->bs = bin.bs;
+    node->weight = bin.weight;
     node->nleaf = 1;
     node->mi = 0;
     node->ref = ref;
@@ -413,37 +453,66 @@ void octreePrune(Pool<Ocnode> &pool, Ocnode **ref, int ncolor)
 {
     assert(ref);
     assert(ncolor > 0);
+    if (!*ref) return;
     int n = (*ref)->nleaf - ncolor;
-    if (!*ref || n <= 0) return;
+    if (n <= 0) return;
     while (n > 0) {
         ocnodeStrip(pool, ref, n, (*ref)->mi);
     }
 }
 
 /**
- * build an octree associated to the area of a color map <rgbmap>,
- * included in the specified (x1,y1)--(x2,y2) rectangle.
+ * build the color histogram of <rgbmap>, splitting the pixels between
+ * threads which each fill their own histogram.
  */
-void octreeBuildArea(Pool<Ocnode> &pool, RgbMap const &rgbmap, Ocnode **ref, int x1, int y1, int x2, int y2, int ncolor)
+std::vector<Bin> histogramBuild(RgbMap const &rgbmap)
 {
-    int dx = x2 - x1, dy = y2 - y1;
-    int xm = x1 + dx / 2, ym = y1 + dy / 2;
-    Ocnode *ref1 = nullptr;
-    Ocnode *ref2 = nullptr;
-    if (dx == 1 && dy == 1) {
-        ocnodeLeaf(pool, ref, rgbmap.getPixel(x1, y1));
-    } else if (dx > dy) {
-        octreeBuildArea(pool, rgbmap, &ref1, x1, y1, xm, y2, ncolor);
-        octreeBuildArea(pool, rgbmap, &ref2, xm, y1, x2, y2, ncolor);
-        octreeMerge(pool, nullptr, ref, ref1, ref2);
+    auto const &pixels = rgbmap.pixels;
+    auto const dispatch_pool = get_global_dispatch_pool();
+    int const nchunks = std::clamp<int>(pixels.size() / HIST_CHUNK_PIXELS, 1, dispatch_pool->size());
+
+    std::vector<std::vector<Bin>> hists(nchunks);
+    dispatch_pool->dispatch(nchunks, [&] (int chunk, int) {
+        auto &hist = hists[chunk];
+        hist.resize(HIST_SIZE);
+        auto const begin = pixels.size() * chunk / nchunks;
+        auto const end = pixels.size() * (chunk + 1) / nchunks;
+        for (auto i = begin; i < end; i++) {
+            auto const rgb = pixels[i];
+            auto &bin = hist[colorIndex<HIST_BITS>(rgb)];
+            bin.weight++;
+            bin.rs += rgb.r; bin.gs += rgb.g; bin.bs += rgb.b;
+        }
+    });
+
+    auto &hist = hists[0];
+    for (int chunk = 1; chunk < nchunks; chunk++) {
+        for (int i = 0; i < HIST_SIZE; i++) {
+            auto const &bin = hists[chunk][i];
+            hist[i].weight += bin.weight;
+            hist[i].rs += bin.rs; hist[i].gs += bin.gs; hist[i].bs += bin.bs;
+        }
+    }
+
+    return std::move(hist);
+}
+
+/**
+ * build an octree associated to the non-empty histogram bins
+ * <indices>[<begin>, <end>).
+ */
+void octreeBuildBins(Pool<Ocnode> &pool, std::vector<Bin> const &hist, std::vector<int> const &indices, Ocnode **ref, int begin, int end)
+{
+    if (end - begin == 1) {
+        ocnodeLeaf(pool, ref, indices[begin], hist[indices[begin]]);
     } else {
-        octreeBuildArea(pool, rgbmap, &ref1, x1, y1, x2, ym, ncolor);
-        octreeBuildArea(pool, rgbmap, &ref2, x1, ym, x2, y2, ncolor);
+        int mid = begin + (end - begin) / 2;
+        Ocnode *ref1 = nullptr;
+        Ocnode *ref2 = nullptr;
+        octreeBuildBins(pool, hist, indices, &ref1, begin, mid);
+        octreeBuildBins(pool, hist, indices, &ref2, mid, end);
         octreeMerge(pool, nullptr, ref, ref1, ref2);
-	}
-
-    // octreePrune(ref, 2 * ncolor);
-    // affects result quality for almost same performance :/
+    }
 }
 
 /**
@@ -452,11 +521,20 @@ void octreeBuildArea(Pool<Ocnode> &pool, RgbMap const &rgbmap, Ocnode **ref, int
  */
 Ocnode *octreeBuild(Pool<Ocnode> &pool, RgbMap const &rgbmap, int ncolor)
 {
+    auto const hist = histogramBuild(rgbmap);
+
+    std::vector<int> indices;
+    for (int i = 0; i < HIST_SIZE; i++) {
+        if (hist[i].weight > 0) {
+            indices.push_back(i);
+        }
+    }
+
     // create the octree
     Ocnode *node = nullptr;
-    octreeBuildArea(pool,
-                    rgbmap, &node,
-                    0, 0, rgbmap.width, rgbmap.height, ncolor);
+    if (!indices.empty()) {
+        octreeBuildBins(pool, hist, indices, &node, 0, indices.size());
+    }
 
     // prune the octree
     octreePrune(pool, &node, ncolor);
@@ -507,6 +585,28 @@ int findRGB(RGB const *rgbs, int ncolor, RGB rgb)
     return index;
 }
 
+/**
+ * build the inverse color lookup table of a palette, giving the index of
+ * the palette color closest to the center of each LUT_BITS color prefix.
+ */
+std::vector<unsigned char> inverseLutBuild(RGB const *rgbs, int ncolor)
+{
+    assert(ncolor <= 256);
+    int constexpr mask = (1 << LUT_BITS) - 1;
+    int constexpr half = 1 << (7 - LUT_BITS);
+
+    std::vector<unsigned char> lut(LUT_SIZE);
+    get_global_dispatch_pool()->dispatch_threshold(LUT_SIZE, ncolor > 8, [&] (int i, int) {
+        RGB center;
+        center.r = (((i >> (2 * LUT_BITS)) & mask) << (8 - LUT_BITS)) | half;
+        center.g = (((i >> LUT_BITS) & mask) << (8 - LUT_BITS)) | half;
+        center.b = ((i & mask) << (8 - LUT_BITS)) | half;
+        lut[i] = findRGB(rgbs, ncolor, center);
+    });
+
+    return lut;
+}
+
 } // namespace
 
 /**
@@ -528,7 +628,7 @@ IndexedMap rgbMapQuantize(RgbMap const &rgbmap, int ncolor)
     octreeDelete(pool, tree);
 
     // stacking with increasing contrasts
-    std::sort(rgbs.get(), rgbs.get() + ncolor, [] (auto &ra, auto &rb) {
+    std::sort(rgbs.get(), rgbs.get() + index, [] (auto &ra, auto &rb) {
         return (ra.r + ra.g + ra.b) < (rb.r + rb.g + rb.b);
     });
 
@@ -539,14 +639,19 @@ IndexedMap rgbMapQuantize(RgbMap const &rgbmap, int ncolor)
     }
     imap.nrColors = index;
 
+    if (index == 0) {
+        return imap;
+    }
+
     // fill in new map pixels
-    for (int y = 0; y < rgbmap.height; y++) {
+    auto const lut = inverseLutBuild(rgbs.get(), index);
+    get_global_dispatch_pool()->dispatch_threshold(rgbmap.height, (std::size_t)rgbmap.width * rgbmap.height > HIST_CHUNK_PIXELS, [&] (int y, int) {
+        auto const src = rgbmap.row(y);
+        auto const dst = imap.row(y);
         for (int x = 0; x < rgbmap.width; x++) {
-            auto rgb = rgbmap.getPixel(x, y);
-            int index = findRGB(rgbs.get(), ncolor, rgb);
-            imap.setPixel(x, y, index);
+            dst[x] = lut[colorIndex<LUT_BITS>(src[x])];
         }
-    }
+    });
 
     return imap;
 }
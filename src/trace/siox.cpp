@@ -15,6 +15,8 @@
 
 #include "siox.h"
 #include "async/progress.h"
+#include "display/dispatch-pool.h"
+#include "display/threading.h"
 
 namespace Inkscape {
 namespace Trace {
@@ -120,36 +122,69 @@ unsigned SioxImage::hash() const
 
 namespace {
 
+int constexpr PARALLEL_MIN_PIXELS = 1 << 16; ///< Images smaller than this are processed on a single thread.
+int constexpr COLUMN_BLOCK = 64;             ///< Width of the column blocks processed by vertical passes.
+
+/**
+ * Call f(y) for every row, in parallel for large enough images.
+ *
+ * Rows must not depend on each other.
+ */
+template <typename F>
+void for_each_row(int xres, int yres, F const &f)
+{
+    get_global_dispatch_pool()->dispatch_threshold(yres, xres * yres >= PARALLEL_MIN_PIXELS, [&] (int y, int) {
+        f(y);
+    });
+}
+
+/**
+ * Call f(x0, x1) for blocks of columns covering the image, in parallel for large enough images.
+ *
+ * Columns must not depend on each other.
+ */
+template <typename F>
+void for_each_column_block(int xres, int yres, F const &f)
+{
+    int const nblocks = (xres + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+    get_global_dispatch_pool()->dispatch_threshold(nblocks, xres * yres >= PARALLEL_MIN_PIXELS, [&] (int i, int) {
+        f(i * COLUMN_BLOCK, std::min(xres, (i + 1) * COLUMN_BLOCK));
+    });
+}
+
 /**
  * Apply a function which updates each pixel depending on the value of its neighbours.
+ *
+ * Each pass only reads neighbours it has not updated yet, so rows are independent during the horizontal passes
+ * and columns during the vertical ones.
  */
 template <typename F>
 void apply_adjacent(float *cm, int xres, int yres, F f)
 {
-    for (int y = 0; y < yres; y++) {
+    for_each_row(xres, yres, [&] (int y) {
         for (int x = 0; x < xres - 1; x++) {
             int idx = y * xres + x;
             f(cm[idx], cm[idx + 1]);
         }
-    }
-    for (int y = 0; y < yres; y++) {
         for (int x = xres - 1; x >= 1; x--) {
             int idx = y * xres + x;
             f(cm[idx], cm[idx - 1]);
         }
-    }
-    for (int y = 0; y < yres - 1; y++) {
-        for (int x = 0; x < xres; x++) {
-            int idx = y * xres + x;
-            f(cm[idx], cm[idx + xres]);
+    });
+    for_each_column_block(xres, yres, [&] (int x0, int x1) {
+        for (int y = 0; y < yres - 1; y++) {
+            for (int x = x0; x < x1; x++) {
+                int idx = y * xres + x;
+                f(cm[idx], cm[idx + xres]);
+            }
         }
-    }
-    for (int y = yres - 1; y >= 1; y--) {
-        for (int x = 0; x < xres; x++) {
-            int idx = y * xres + x;
-            f(cm[idx], cm[idx - xres]);
+        for (int y = yres - 1; y >= 1; y--) {
+            for (int x = x0; x < x1; x++) {
+                int idx = y * xres + x;
+                f(cm[idx], cm[idx - xres]);
+            }
         }
-    }
+    });
 }
 
 /**
@@ -216,30 +251,30 @@ void normalizeMatrix(float *cm, int cmSize)
  */
 void smooth(float *cm, int xres, int yres, float f1, float f2, float f3)
 {
-    for (int y = 0; y < yres; y++) {
+    for_each_row(xres, yres, [&] (int y) {
         for (int x = 0; x < xres - 2; x++) {
             int idx = y * xres + x;
             cm[idx] = f1 * cm[idx] + f2 * cm[idx + 1] + f3 * cm[idx + 2];
         }
-    }
-    for (int y = 0; y < yres; y++) {
         for (int x = xres - 1; x >= 2; x--) {
             int idx = y * xres + x;
             cm[idx] = f3 * cm[idx - 2] + f2 * cm[idx - 1] + f1 * cm[idx];
         }
-    }
-    for (int y = 0; y < yres - 2; y++) {
-        for (int x = 0; x < xres; x++) {
-            int idx = y * xres + x;
-            cm[idx] = f1 * cm[idx] + f2 * cm[((y + 1) * xres) + x] + f3 * cm[((y + 2) * xres) + x];
+    });
+    for_each_column_block(xres, yres, [&] (int x0, int x1) {
+        for (int y = 0; y < yres - 2; y++) {
+            for (int x = x0; x < x1; x++) {
+                int idx = y * xres + x;
+                cm[idx] = f1 * cm[idx] + f2 * cm[((y + 1) * xres) + x] + f3 * cm[((y + 2) * xres) + x];
+            }
         }
-    }
-    for (int y = yres - 1; y >= 2; y--) {
-        for (int x = 0; x < xres; x++) {
-            int idx = y * xres + x;
-            cm[idx] = f3 * cm[((y - 2) * xres) + x] + f2 * cm[((y - 1) * xres) + x] + f1 * cm[idx];
+        for (int y = yres - 1; y >= 2; y--) {
+            for (int x = x0; x < x1; x++) {
+                int idx = y * xres + x;
+                cm[idx] = f3 * cm[((y - 2) * xres) + x] + f2 * cm[((y - 1) * xres) + x] + f1 * cm[idx];
+            }
         }
-    }
+    });
 }
 
 /**
@@ -255,6 +290,47 @@ float sqrEuclideanDist(float *p, int pSize, float *q)
     return sum;
 }
 
+/**
+ * A color signature stored as separate component arrays, so that the distances to all of its entries
+ * are computed by a loop the compiler can vectorize.
+ */
+class SignatureLanes
+{
+public:
+    explicit SignatureLanes(std::vector<CieLab> const &signature)
+    {
+        L.reserve(signature.size());
+        A.reserve(signature.size());
+        B.reserve(signature.size());
+        for (auto const &s : signature) {
+            L.push_back(s.L);
+            A.push_back(s.A);
+            B.push_back(s.B);
+        }
+    }
+
+    bool empty() const { return L.empty(); }
+
+    /**
+     * Smallest squared distance from lab to an entry of the signature.
+     */
+    float minDiffSq(CieLab const &lab) const
+    {
+        float min = std::numeric_limits<float>::max();
+        for (std::size_t i = 0; i < L.size(); i++) {
+            float dl = L[i] - lab.L;
+            float da = A[i] - lab.A;
+            float db = B[i] - lab.B;
+            float d = dl * dl + da * da + db * db;
+            min = d < min ? d : min;
+        }
+        return min;
+    }
+
+private:
+    std::vector<float> L, A, B;
+};
+
 } // namespace
 
 Siox::Siox(Async::Progress<double> &progress)
@@ -299,17 +375,22 @@ SioxImage Siox::extractForeground(SioxImage const &originalImage, uint32_t backg
     // Create color signatures.
     std::vector<CieLab> knownBg, knownFg;
     auto imageClab = std::make_unique<CieLab[]>(pixelCount);
+    for_each_row(width, height, [&, this] (int y) {
+        for (int i = y * width; i < (y + 1) * width; i++) {
+            if (cm[i] <= BACKGROUND_CONFIDENCE || cm[i] >= FOREGROUND_CONFIDENCE) {
+                imageClab[i] = image[i];
+            }
+        }
+    });
     for (int i = 0; i < pixelCount; i++) {
         float conf = cm[i];
-        uint32_t pix = image[i];
-        CieLab lab = pix;
-        imageClab[i] = lab;
         if (conf <= BACKGROUND_CONFIDENCE) {
-            knownBg.emplace_back(lab);
+            knownBg.emplace_back(imageClab[i]);
         } else if (conf >= FOREGROUND_CONFIDENCE) {
-            knownFg.emplace_back(lab);
+            knownFg.emplace_back(imageClab[i]);
         }
     }
+    imageClab.reset();
 
     progress->report_or_throw(0.1);
 
@@ -334,52 +415,51 @@ SioxImage Siox::extractForeground(SioxImage const &originalImage, uint32_t backg
     progress->report_or_throw(0.3);
 
     // classify using color signatures,
-    // classification cached in hashmap for drb and speedup purposes
+    // classification cached in hashmaps for drb and speedup purposes
     trace("### Analyzing image");
 
-    std::unordered_map<uint32_t, bool> hs;
+    auto const pool = get_global_dispatch_pool();
+    auto const bgLanes = SignatureLanes(bgSignature);
+    auto const fgLanes = SignatureLanes(fgSignature);
 
-    int progressResolution = pixelCount / 10;
+    // One cache per thread, so that they need no locking.
+    std::vector<std::unordered_map<uint32_t, bool>> caches(pool->size());
 
-    for (int i = 0; i < pixelCount; i++) {
-        if (i % progressResolution == 0) {
-            progress->report_or_throw(0.3 + 0.6 * i / pixelCount);
-        }
-
-        if (cm[i] >= FOREGROUND_CONFIDENCE) {
-            cm[i] = CERTAIN_FOREGROUND_CONFIDENCE;
-        } else if (cm[i] <= BACKGROUND_CONFIDENCE) {
-            cm[i] = CERTAIN_BACKGROUND_CONFIDENCE;
-        } else { // somewhere in between
-            auto [it, inserted] = hs.emplace(image[i], false);
-            if (inserted) {
-                auto const &lab = imageClab[i];
-
-                float minBg = std::numeric_limits<float>::max();
-                for (auto const &s : bgSignature) {
-                    minBg = std::min(minBg, CieLab::diffSq(lab, s));
-                }
-
-                float minFg;
-                if (fgSignature.empty()) {
-                    minFg = clusterSize;
-                } else {
-                    minFg = std::numeric_limits<float>::max();
-                    for (auto const &s : fgSignature) {
-                        minFg = std::min(minFg, CieLab::diffSq(lab, s));
-                    }
+    auto classify_row = [&, this] (int y, int local_id) {
+        auto &hs = caches[local_id];
+        for (int i = y * width; i < (y + 1) * width; i++) {
+            if (cm[i] >= FOREGROUND_CONFIDENCE) {
+                cm[i] = CERTAIN_FOREGROUND_CONFIDENCE;
+            } else if (cm[i] <= BACKGROUND_CONFIDENCE) {
+                cm[i] = CERTAIN_BACKGROUND_CONFIDENCE;
+            } else { // somewhere in between
+                auto [it, inserted] = hs.emplace(image[i], false);
+                if (inserted) {
+                    CieLab lab = image[i];
+                    float minBg = bgLanes.minDiffSq(lab);
+                    float minFg = fgLanes.empty() ? clusterSize : fgLanes.minDiffSq(lab);
+                    it->second = minBg < minFg;
                 }
 
-                it->second = minBg < minFg;
+                bool isBackground = it->second;
+                cm[i] = isBackground ? CERTAIN_BACKGROUND_CONFIDENCE : CERTAIN_FOREGROUND_CONFIDENCE;
             }
-
-            bool isBackground = it->second;
-            cm[i] = isBackground ? CERTAIN_BACKGROUND_CONFIDENCE : CERTAIN_FOREGROUND_CONFIDENCE;
         }
+    };
+
+    // Classify in batches of rows, reporting progress in between.
+    int constexpr progressResolution = 10;
+    for (int batch = 0; batch < progressResolution; batch++) {
+        progress->report_or_throw(0.3 + 0.6 * batch / progressResolution);
+
+        int const y0 = height * batch / progressResolution;
+        int const y1 = height * (batch + 1) / progressResolution;
+        pool->dispatch_threshold(y1 - y0, pixelCount >= PARALLEL_MIN_PIXELS, [&] (int y, int local_id) {
+            classify_row(y0 + y, local_id);
+        });
     }
 
-    hs.clear();
-    imageClab.reset();
+    caches.clear();
 
     trace("### postProcessing");
 
@@ -16,17 +16,25 @@
 
 #include "clipboard.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <boost/bimap.hpp>
 
+#include <glibmm/fileutils.h>
 #include <glibmm/i18n.h>
 #include <glibmm/main.h>
 #include <glibmm/miscutils.h>
 #include <glibmm/value.h>
 #include <giomm/application.h>
 #include <giomm/asyncresult.h>
+#include <giomm/memoryinputstream.h>
+#include <cairomm/surface.h>
 #include <gdkmm/clipboard.h>
 
 #include <2geom/transforms.h>
@@ -52,7 +60,11 @@
 #include "selection-chemistry.h"
 #include "style.h"
 
+#include "async/async.h"
+#include "async/channel.h"
 #include "display/curve.h"
+#include "display/drawing.h"
+#include "display/drawing-context.h"
 #include "extension/db.h" // extension database
 #include "extension/find_extension_by_mime.h"
 #include "extension/input.h"
@@ -191,6 +203,56 @@ std::string get_tmp_filename(char const *suffix)
     return Glib::build_filename(Glib::get_user_cache_dir(), suffix);
 }
 
+/// Largest number of pixels rendered for a raster clipboard target; bigger exports are downscaled.
+constexpr double CLIPBOARD_RASTER_MAX_PIXELS = 4096.0 * 4096.0;
+
+/**
+ * The serialized contents of the clipboard for one target, cached so that repeated requests
+ * for the same target don't export the clipboard document again.
+ *
+ * PNG data is rendered in the background from a drawing of the clipboard document, which
+ * together with the document is kept alive here until the render has finished.
+ */
+struct ClipboardTargetData
+{
+    std::optional<std::string> data; ///< The exported bytes, once available
+
+    std::shared_ptr<SPDocument> document; ///< Copy of the clipboard document being rendered in the background
+    std::unique_ptr<Inkscape::Drawing> drawing;
+    unsigned dkey = 0;
+    Inkscape::Async::Channel::Dest channel; ///< Receives the result of the background render
+
+    /// Store the rendered data and release the drawing. Must be called in the main thread.
+    void finish(std::string &&result)
+    {
+        data = std::move(result);
+        document->getRoot()->invoke_hide(dkey);
+        drawing.reset();
+        document.reset();
+    }
+};
+
+/**
+ * Get the area of a document to rasterize for the clipboard, and its size in pixels at 96 dpi,
+ * reduced proportionally if it exceeds CLIPBOARD_RASTER_MAX_PIXELS.
+ *
+ * @returns The scale applied to the default resolution, which is 1.0 unless downscaled.
+ */
+double clipboard_raster_area(SPDocument *doc, Geom::Rect &area, unsigned long &width, unsigned long &height)
+{
+    auto origin = Geom::Point(doc->getRoot()->x.computed, doc->getRoot()->y.computed);
+    area = Geom::Rect(origin, origin + doc->getDimensions());
+
+    double scale = 1.0;
+    if (area.area() > CLIPBOARD_RASTER_MAX_PIXELS) {
+        scale = std::sqrt(CLIPBOARD_RASTER_MAX_PIXELS / area.area());
+    }
+
+    width  = std::max(1ul, static_cast<unsigned long>(area.width()  * scale + 0.5));
+    height = std::max(1ul, static_cast<unsigned long>(area.height() * scale + 0.5));
+    return scale;
+}
+
 /**
  * Default implementation of the clipboard manager.
  */
@@ -234,6 +296,8 @@ private:
 
     // clipboard callbacks
     void _onGet(char const *mime_type, Glib::RefPtr<Gio::OutputStream> const &output);
+    std::shared_ptr<ClipboardTargetData> _exportTarget(Glib::ustring const &target);
+    std::shared_ptr<ClipboardTargetData> _renderPng();
 
     // various helpers
     void _createInternalClipboard();
@@ -247,7 +311,8 @@ private:
     void _userWarn(SPDesktop *, char const *);
 
     // private properties
-    std::unique_ptr<SPDocument> _clipboardSPDoc; ///< Document that stores the clipboard until someone requests it
+    std::shared_ptr<SPDocument> _clipboardSPDoc; ///< Document that stores the clipboard until someone requests it
+    std::map<Glib::ustring, std::shared_ptr<ClipboardTargetData>> _targetCache; ///< Exported data of _clipboardSPDoc by target
     Inkscape::XML::Node *_defs; ///< Reference to the clipboard document's defs node
     Inkscape::XML::Node *_root; ///< Reference to the clipboard's root node
     Inkscape::XML::Node *_clipnode; ///< The node that holds extra information
@@ -1734,6 +1799,7 @@ void ClipboardManagerImpl::_retrieveClipboard(Glib::ustring best_target)
         return;
     }
 
+    _targetCache.clear();
     try {
         _clipboardSPDoc = (*in)->open(filename.c_str());
     } catch (...) {
@@ -1743,8 +1809,8 @@ void ClipboardManagerImpl::_retrieveClipboard(Glib::ustring best_target)
 /**
  * Callback called when some other application requests data from Inkscape.
  *
- * Finds a suitable output extension to save the internal clipboard document,
- * then saves it to memory and sets the clipboard contents.
+ * Exports the internal clipboard document in the requested format, or reuses an earlier export
+ * of it, and streams the result to the requesting application.
  */
 void ClipboardManagerImpl::_onGet(char const *mime_type, Glib::RefPtr<Gio::OutputStream> const &output)
 {
@@ -1770,8 +1836,63 @@ void ClipboardManagerImpl::_onGet(char const *mime_type, Glib::RefPtr<Gio::Outpu
     }
 #endif
 
+    // Hold a reference, since the cache may be cleared while the event loop is running.
+    std::shared_ptr<ClipboardTargetData> entry;
+    if (auto it = _targetCache.find(target); it != _targetCache.end()) {
+        entry = it->second;
+    } else {
+        auto const doc = _clipboardSPDoc;
+        entry = _exportTarget(target);
+        if (_clipboardSPDoc == doc) {
+            _targetCache[target] = entry;
+        }
+    }
+    pump_until([&] { return entry->data.has_value(); });
+
+    if (entry->data->empty()) {
+        return;
+    }
+
+    try {
+        auto in = Gio::MemoryInputStream::create();
+        in->add_bytes(Glib::Bytes::create(entry->data->data(), entry->data->size()));
+
+        bool done = false;
+        output->splice_async(in, [&] (auto &result) {
+            output->splice_finish(result);
+            done = true;
+        });
+        pump_until([&] { return done; });
+    } catch (...) {
+    }
+}
+
+/**
+ * Export the internal clipboard document for the given target.
+ *
+ * PNG is rendered in the background and the returned data becomes available later on. All other
+ * formats go through their output extension, which requires the main thread.
+ */
+std::shared_ptr<ClipboardTargetData> ClipboardManagerImpl::_exportTarget(Glib::ustring const &target)
+{
+    if (target == "image/png") {
+        return _renderPng();
+    }
+
+    auto entry = std::make_shared<ClipboardTargetData>();
+    entry->data.emplace();
+
+    Extension::DB::OutputList outlist;
+    Extension::db.get_output_list(outlist);
+    auto out = outlist.begin();
+    for ( ; out != outlist.end() && target != (*out)->get_mimetype(); ++out) {
+    }
+    if (out == outlist.end()) {
+        return entry;
+    }
+
     // FIXME: Temporary hack until we add support for memory output.
-    // Save to a temporary file, read it back and then set the clipboard contents
+    // Save to a temporary file and read it back.
     auto const filename = get_tmp_filename("inkscape-clipboard-export");
 
     // XXX This is a crude fix for clipboards accessing extensions
@@ -1780,25 +1901,18 @@ void ClipboardManagerImpl::_onGet(char const *mime_type, Glib::RefPtr<Gio::Outpu
     INKSCAPE.use_gui(false);
 
     try {
-        Extension::DB::OutputList outlist;
-        Extension::db.get_output_list(outlist);
-        auto out = outlist.begin();
-        for ( ; out != outlist.end() && target != (*out)->get_mimetype(); ++out) {
-        }
         if (!(*out)->loaded()) {
             // Need to load the extension.
             (*out)->set_state(Inkscape::Extension::Extension::STATE_LOADED);
         }
 
         if ((*out)->is_raster()) {
-            double dpi = Inkscape::Util::Quantity::convert(1, "in", "px");
             uint32_t bgcolor = 0x00000000;
 
-            auto origin = Geom::Point(_clipboardSPDoc->getRoot()->x.computed, _clipboardSPDoc->getRoot()->y.computed);
-            auto area = Geom::Rect(origin, origin + _clipboardSPDoc->getDimensions());
-
-            auto width  = static_cast<unsigned long>(area.width() + 0.5);
-            auto height = static_cast<unsigned long>(area.height() + 0.5);
+            Geom::Rect area;
+            unsigned long width, height;
+            double const dpi = Inkscape::Util::Quantity::convert(1, "in", "px")
+                             * clipboard_raster_area(_clipboardSPDoc.get(), area, width, height);
 
             // read from namedview
             auto const raster_file = Glib::filename_to_utf8(get_tmp_filename("inkscape-clipboard-export-raster"));
@@ -1809,22 +1923,76 @@ void ClipboardManagerImpl::_onGet(char const *mime_type, Glib::RefPtr<Gio::Outpu
             (*out)->save(_clipboardSPDoc.get(), filename.c_str(), true);
         }
 
-        auto file = Gio::File::create_for_path(filename);
-        auto in = file->read();
-
-        bool done = false;
-        output->splice_async(in, [&] (auto &result) {
-            output->splice_finish(result);
-            done = true;
-        });
-        pump_until([&] { return done; });
-
-        file->remove();
+        *entry->data = Glib::file_get_contents(filename);
     } catch (...) {
     }
 
     INKSCAPE.use_gui(previous_gui);
     unlink(filename.c_str()); // delete the temporary file
+
+    return entry;
+}
+
+/**
+ * Start rendering the internal clipboard document to PNG in the background.
+ *
+ * The drawing is built and updated here in the main thread from a copy of the document that
+ * nothing else touches; the worker only renders it and encodes the result, then hands the bytes
+ * back to the main thread through a channel.
+ */
+std::shared_ptr<ClipboardTargetData> ClipboardManagerImpl::_renderPng()
+{
+    auto entry = std::make_shared<ClipboardTargetData>();
+
+    Geom::Rect area;
+    unsigned long width, height;
+    clipboard_raster_area(_clipboardSPDoc.get(), area, width, height);
+    if (area.hasZeroArea()) {
+        entry->data.emplace();
+        return entry;
+    }
+
+    // Render from a private copy. While the render runs, the event loop may serve requests for
+    // other targets, and saving through an output extension modifies the document it is given.
+    entry->document = _clipboardSPDoc->copy();
+    entry->document->ensureUpToDate();
+    entry->drawing = std::make_unique<Inkscape::Drawing>();
+    entry->dkey = SPItem::display_key_new(1);
+
+    auto &drawing = *entry->drawing;
+    auto const bbox = Geom::IntRect(0, 0, width, height);
+    drawing.setRoot(entry->document->getRoot()->invoke_show(drawing, entry->dkey, SP_ITEM_SHOW_DISPLAY));
+    drawing.root()->setTransform(Geom::Translate(-area.min()) * Geom::Scale(width / area.width(), height / area.height()));
+    drawing.setExact(); // export with maximum blur rendering quality
+    drawing.update(bbox);
+
+    auto [src, dst] = Async::Channel::create();
+    entry->channel = std::move(dst);
+
+    // The entry outlives the render: it is only dropped once its data has arrived.
+    Async::fire_and_forget([src = std::move(src), drawing = &drawing, entry = entry.get(), bbox] () mutable {
+        std::string png;
+        try {
+            auto surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, bbox.width(), bbox.height());
+            {
+                auto dc = Inkscape::DrawingContext(surface->cobj(), Geom::Point());
+                drawing->render(dc, bbox);
+            }
+            surface->flush();
+            surface->write_to_png_stream([&] (unsigned char const *data, unsigned length) {
+                png.append(reinterpret_cast<char const *>(data), length);
+                return CAIRO_STATUS_SUCCESS;
+            });
+        } catch (...) {
+            png.clear();
+        }
+
+        src.run([entry, png = std::move(png)] () mutable {
+            entry->finish(std::move(png));
+        });
+    });
+
+    return entry;
 }
 
 /**
@@ -1832,6 +2000,7 @@ void ClipboardManagerImpl::_onGet(char const *mime_type, Glib::RefPtr<Gio::Outpu
  */
 void ClipboardManagerImpl::_createInternalClipboard()
 {
+    _targetCache.clear();
     _clipboardSPDoc = SPDocument::createNewDoc(nullptr, false, true);
     assert(_clipboardSPDoc);
     _defs = _clipboardSPDoc->getDefs()->getRepr();
@@ -1861,6 +2030,7 @@ void ClipboardManagerImpl::_createInternalClipboard()
  */
 void ClipboardManagerImpl::_discardInternalClipboard()
 {
+    _targetCache.clear();
     if (_clipboardSPDoc) {
         _clipboardSPDoc.reset();
         _defs = nullptr;
@@ -2007,6 +2177,9 @@ void ClipboardManagerImpl::_registerSerializers()
  */
 void ClipboardManagerImpl::_setClipboardTargets()
 {
+    // The clipboard document has changed, so earlier exports of it are stale.
+    _targetCache.clear();
+
 #ifdef _WIN32
     // If the "image/x-emf" target handled by the emf extension would be
     // presented as a CF_ENHMETAFILE automatically (just like an "image/bmp"
@@ -1338,7 +1338,7 @@ void FilterEffectsDialog::FilterModifier::update_selection(Selection *sel)
 
         if (style->filter.set && style->getFilter()) {
             //TODO: why is this needed?
-            obj->bbox_valid = FALSE;
+            obj->invalidateBoundsCache();
             used.insert(style->getFilter());
         }
     }
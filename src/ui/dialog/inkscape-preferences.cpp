@@ -2313,6 +2313,14 @@ void InkscapePreferences::initPageIO()
     _page_io.add_line( false, "", _export_all_extensions, "",
                            _("Will list all possible output extensions in the Export Dialog selection."), true);
 
+    _document_cache.init( _("Cache large documents for faster reopening"), "/options/documentcache/enabled", false);
+    _page_io.add_line( false, "", _document_cache, "",
+                           _("Keep a parsed copy of large SVG files in the user cache directory, so they open faster next time. The copy is discarded whenever the file changes."), true);
+
+    _lazy_build.init( _("Build hidden layers and unused definitions on demand"), "/options/lazybuild/enabled", false);
+    _page_io.add_line( false, "", _lazy_build, "",
+                           _("When opening a file, skip the contents of hidden layers and unreferenced gradients, patterns, filters, markers and symbols until they are shown or used. Speeds up opening large template files."), true);
+
     // Input devices options
     _mouse_sens.init ( "/options/cursortolerance/value", 0.0, 30.0, 1.0, 1.0, 8.0, true, false);
     _page_mouse.add_line( false, _("_Grab sensitivity:"), _mouse_sens, _("pixels"),
@@ -2922,6 +2930,8 @@ void InkscapePreferences::initPageRendering()
     // opengl
     _canvas_request_opengl.init(_("Enable OpenGL"), "/options/rendering/request_opengl", false);
     _page_rendering.add_line(false, "", _canvas_request_opengl, "", _("Request that the canvas should be painted with OpenGL rather than Cairo. If OpenGL is unsupported, it will fall back to Cairo."), false);
+    _canvas_progressive_render.init(_("Progressive rendering"), "/options/rendering/progressive_render", false);
+    _page_rendering.add_line(false, "", _canvas_progressive_render, "", _("While zooming or panning, draw quickly at reduced quality with simplified filters, then refine to full quality once the view stops moving."), false);
 
     // blur quality
     _blur_quality_best.init ( _("Best quality (slowest)"), "/options/blurquality/value",
@@ -3050,10 +3060,12 @@ void InkscapePreferences::initPageRendering()
     add_devmode_line(_("Glue size for coarsener algorithm"), _canvas_coarsener_glue_size, C_("pixel abbreviation", "px"), _("Coarsener algorithm absorbs nearby rectangles within this distance."));
     _canvas_coarsener_min_fullness.init("/options/rendering/coarsener_min_fullness", 0.0, 1.0, 0.0, 0.0, 0.3, false, false);
     add_devmode_line(_("Min fullness for coarsener algorithm"), _canvas_coarsener_min_fullness, "", _("Refuse coarsening algorithm's attempt if the result would be more empty than this."));
+    _canvas_tile_pyramid_size.init("/options/rendering/tile_pyramid_size", 0.0, 4096.0, 1.0, 0.0, 64.0, true, false);
+    add_devmode_line(_("Tile pyramid size"), _canvas_tile_pyramid_size, C_("mebibyte (2^20 bytes) abbreviation", "MiB"), _("Keep content rendered at previous zoom levels up to this much memory, to show it again immediately when returning to them. Zero disables it."));
 
     add_devmode_group_header(_("Debugging, profiling and experiments"));
     _canvas_debug_framecheck.init("", "/options/rendering/debug_framecheck", false);
-    add_devmode_line(_("Framecheck"), _canvas_debug_framecheck, "", _("Print profiling data of selected operations to a file"));
+    add_devmode_line(_("Framecheck"), _canvas_debug_framecheck, "", _("Record profiling data of selected operations. Export it with the render-trace action, and query statistics with render-counters."));
     _canvas_debug_logging.init("", "/options/rendering/debug_logging", false);
     add_devmode_line(_("Logging"), _canvas_debug_logging, "", _("Log certain events to the console"));
     _canvas_debug_delay_redraw.init("", "/options/rendering/debug_delay_redraw", false);
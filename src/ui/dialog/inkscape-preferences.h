@@ -347,6 +347,7 @@ protected:
     UI::Widget::PrefSpinButton  _rendering_outline_overlay_opacity;
     UI::Widget::PrefCombo       _canvas_update_strategy;
     UI::Widget::PrefCheckButton _canvas_request_opengl;
+    UI::Widget::PrefCheckButton _canvas_progressive_render;
     UI::Widget::PrefRadioButton _blur_quality_best;
     UI::Widget::PrefRadioButton _blur_quality_better;
     UI::Widget::PrefRadioButton _blur_quality_normal;
@@ -371,6 +372,7 @@ protected:
     UI::Widget::PrefSpinButton  _canvas_coarsener_min_size;
     UI::Widget::PrefSpinButton  _canvas_coarsener_glue_size;
     UI::Widget::PrefSpinButton  _canvas_coarsener_min_fullness;
+    UI::Widget::PrefSpinButton  _canvas_tile_pyramid_size;
     UI::Widget::PrefCheckButton _canvas_debug_framecheck;
     UI::Widget::PrefCheckButton _canvas_debug_logging;
     UI::Widget::PrefCheckButton _canvas_debug_delay_redraw;
@@ -432,6 +434,8 @@ protected:
     UI::Widget::PrefCheckButton _misc_comment;
     UI::Widget::PrefCheckButton _misc_default_metadata;
     UI::Widget::PrefCheckButton _export_all_extensions;
+    UI::Widget::PrefCheckButton _document_cache;
+    UI::Widget::PrefCheckButton _lazy_build;
     UI::Widget::PrefCheckButton _misc_forkvectors;
     UI::Widget::PrefSpinButton  _misc_gradientangle;
     UI::Widget::PrefSpinButton  _recently_used_fonts_size;
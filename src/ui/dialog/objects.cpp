@@ -49,6 +49,7 @@
 #include "inkscape-window.h"
 #include "layer-manager.h"
 #include "message-stack.h"
+#include "object/deferred-build.h"
 #include "object/sp-root.h"
 #include "object/sp-shape.h"
 #include "style-enums.h"
@@ -550,6 +551,11 @@ void ObjectWatcher::addChildren(SPItem *obj, bool dummy)
 {
     assert(child_watchers.empty());
 
+    // With lazy building, the contents of hidden layers may not exist yet. One child is enough for a dummy row.
+    if (auto deferred = obj->document->getDeferredBuild()) {
+        deferred->buildChildren(obj, dummy);
+    }
+
     for (auto &child : obj->children) {
         if (auto item = cast<SPItem>(&child)) {
             if (addChild(item, dummy) && dummy) {
@@ -76,6 +76,7 @@ using namespace std::literals;
 #include "include/gtkmm_version.h"
 
 #include "io/resource.h"
+#include "object/deferred-build.h"
 #include "object/sp-defs.h"
 #include "object/sp-root.h"
 #include "object/sp-symbol.h"
@@ -540,6 +541,11 @@ void SymbolsDialog::rebuild(bool clear_image_cache) {
 void collect_symbols(SPObject* object, std::vector<SPSymbol*>& symbols) {
     if (!object) return;
 
+    // Symbols of a lazily built document may not have objects yet
+    if (auto deferred = object->document->getDeferredBuild(); deferred && object == object->document->getRoot()) {
+        deferred->buildResources("symbol");
+    }
+
     if (auto symbol = cast<SPSymbol>(object)) {
         symbols.push_back(symbol);
     }
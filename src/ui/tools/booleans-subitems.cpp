@@ -13,13 +13,18 @@
 
 #include "booleans-subitems.h"
 
+#include <algorithm>
+#include <cmath>
 #include <numeric>
+#include <optional>
+#include <unordered_map>
 #include <utility>
-#include <random>
 
 #include <boost/range/adaptor/reversed.hpp>
 
 #include "style.h"
+#include "display/dispatch-pool.h"
+#include "display/threading.h"
 #include "helper/geom-pathstroke.h"
 #include "livarot/LivarotDefs.h"
 #include "livarot/Shape.h"
@@ -118,6 +123,145 @@ static FillRule sp_to_livarot(SPWindRule fillrule)
     return fillrule == SP_WIND_RULE_NONZERO ? fill_nonZero : fill_oddEven;
 }
 
+/**
+ * Group items into clusters whose bounding boxes overlap, directly or through other items.
+ * Items in different clusters cannot touch, so each cluster can be fractured on its own.
+ * Each cluster lists its items in their original order.
+ */
+static std::vector<std::vector<int>> cluster_by_bounds(std::vector<Geom::OptRect> const &rects)
+{
+    std::vector<int> parent(rects.size());
+    std::iota(parent.begin(), parent.end(), 0);
+
+    auto find = [&] (int i) {
+        while (parent[i] != i) {
+            i = parent[i] = parent[parent[i]];
+        }
+        return i;
+    };
+
+    std::vector<int> by_left;
+    for (int i = 0; i < rects.size(); i++) {
+        if (rects[i]) {
+            by_left.emplace_back(i);
+        }
+    }
+    std::sort(by_left.begin(), by_left.end(), [&] (int a, int b) { return rects[a]->left() < rects[b]->left(); });
+
+    for (int a = 0; a < by_left.size(); a++) {
+        auto const &ra = *rects[by_left[a]];
+        for (int b = a + 1; b < by_left.size() && rects[by_left[b]]->left() <= ra.right(); b++) {
+            if (ra.intersects(*rects[by_left[b]])) {
+                parent[find(by_left[a])] = find(by_left[b]);
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> result;
+    std::unordered_map<int, int> cluster_of_root;
+
+    for (int i = 0; i < rects.size(); i++) {
+        if (!rects[i]) {
+            continue;
+        }
+        auto [it, inserted] = cluster_of_root.emplace(find(i), result.size());
+        if (inserted) {
+            result.emplace_back();
+        }
+        result[it->second].emplace_back(i);
+    }
+
+    return result;
+}
+
+/**
+ * A uniform grid over a set of bounding boxes, each cell listing the boxes that overlap it, in order.
+ */
+class BoundsGrid
+{
+public:
+    BoundsGrid(Geom::Rect const &area, std::vector<Geom::OptRect> const &rects, std::vector<int> const &indices)
+        : _area(area)
+        , _size(std::max(1, (int)std::ceil(std::sqrt(indices.size()))))
+        , _cells(_size * _size)
+    {
+        for (auto i : indices) {
+            auto const [x0, y0] = _cell(rects[i]->min());
+            auto const [x1, y1] = _cell(rects[i]->max());
+            for (int y = y0; y <= y1; y++) {
+                for (int x = x0; x <= x1; x++) {
+                    _cells[y * _size + x].emplace_back(i);
+                }
+            }
+        }
+    }
+
+    std::vector<int> const &at(Geom::Point const &pt) const
+    {
+        auto const [x, y] = _cell(pt);
+        return _cells[y * _size + x];
+    }
+
+private:
+    std::pair<int, int> _cell(Geom::Point const &pt) const
+    {
+        auto const rel = pt - _area.min();
+        auto const cell = [&] (Geom::Dim2 d) {
+            auto const extent = _area.dimensions()[d];
+            int const c = extent > 0 ? std::floor(rel[d] / extent * _size) : 0;
+            return std::clamp(c, 0, _size - 1);
+        };
+        return { cell(Geom::X), cell(Geom::Y) };
+    }
+
+    Geom::Rect _area;
+    int _size;
+    std::vector<std::vector<int>> _cells;
+};
+
+/**
+ * Find a few points well inside a piece, by cutting it with horizontal lines
+ * and taking the middle of the widest inside span of each.
+ */
+static std::vector<Geom::Point> interior_points(Geom::PathVector const &piece, Geom::Rect const &rect)
+{
+    std::vector<Geom::Point> result;
+
+    for (double frac : {0.5, 0.25, 0.75}) {
+        double const y = rect.top() + frac * rect.height();
+
+        std::vector<double> xs;
+        for (auto const &path : piece) {
+            for (auto const &t : path.roots(y, Geom::Y)) {
+                xs.emplace_back(path.pointAt(t)[Geom::X]);
+            }
+        }
+        std::sort(xs.begin(), xs.end());
+
+        std::optional<Geom::Point> best;
+        double best_width = 0.0;
+        for (int i = 1; i < xs.size(); i++) {
+            auto const width = xs[i] - xs[i - 1];
+            auto const mid = Geom::Point((xs[i] + xs[i - 1]) / 2, y);
+            if (width > best_width && piece.winding(mid)) {
+                best_width = width;
+                best = mid;
+            }
+        }
+
+        if (best) {
+            result.emplace_back(*best);
+        }
+    }
+
+    // Degenerate pieces that no line found anything inside of.
+    if (result.empty() && piece.winding(rect.midpoint())) {
+        result.emplace_back(rect.midpoint());
+    }
+
+    return result;
+}
+
 /**
  * Take a list of items and fracture into a list of SubItems ready for
  * use inside the booleans interactive tool.
@@ -144,106 +288,112 @@ WorkItems SubItem::build_mosaic(std::vector<SPItem*> &&items)
         return is<SPImage>(pvi.item) || is<SPUse>(pvi.item);
     });
 
-    // Compute a slightly expanded bounding box, collect together all lines, and cut the former by the latter.
-    Geom::OptRect bounds;
-    Geom::PathVector lines;
+    // Gather everything the worker threads need, so they never touch the objects themselves.
+    std::vector<Geom::OptRect> rects;
+    std::vector<bool> nonzero;
 
     for (auto &pvi : augmented) {
-        bounds |= pvi.pathv.boundsExact();
-        for (auto &path : pvi.pathv) {
-            lines.push_back(path);
-        }
+        rects.emplace_back(pvi.pathv.boundsExact());
+        nonzero.emplace_back(pvi.item->style->fill_rule.computed == SP_WIND_RULE_NONZERO);
     }
 
-    if (!bounds) {
-        return {};
-    }
-
-    constexpr double expansion = 10.0;
-    bounds->expandBy(expansion);
+    // Cut each cluster of overlapping items separately, in parallel.
+    auto const clusters = cluster_by_bounds(rects);
+    std::vector<std::vector<std::pair<Geom::PathVector, PathvectorItem*>>> cluster_pieces(clusters.size());
 
-    auto bounds_pathv = Geom::PathVector(Geom::Path(*bounds));
-    auto pieces = pathvector_cut(bounds_pathv, lines);
+    get_global_dispatch_pool()->dispatch_threshold(clusters.size(), clusters.size() > 1, [&] (int c, int) {
+        auto const &cluster = clusters[c];
 
-    // Construct the SubItems, attempting to guess the corresponding augmented item for each piece.
-    WorkItems result;
+        // Compute a slightly expanded bounding box, collect together all lines, and cut the former by the latter.
+        Geom::OptRect bounds;
+        Geom::PathVector lines;
 
-    auto gen = std::default_random_engine(std::random_device()());
-    auto ranf = [&] { return std::uniform_real_distribution()(gen); };
-    auto randpt = [&] { return Geom::Point(ranf(), ranf()); };
-
-    for (auto &piece : pieces) {
-        // Skip the big enclosing piece that is touching the outer boundary.
-        if (auto rect = piece.boundsExact()) {
-            if (   Geom::are_near(rect->top(), bounds->top(), expansion / 2)
-                || Geom::are_near(rect->bottom(), bounds->bottom(), expansion / 2)
-                || Geom::are_near(rect->left(), bounds->left(), expansion / 2)
-                || Geom::are_near(rect->right(), bounds->right(), expansion / 2))
-            {
-                continue;
+        for (auto i : cluster) {
+            bounds |= rects[i];
+            for (auto &path : augmented[i].pathv) {
+                lines.push_back(path);
             }
         }
 
-        // Remove junk paths that are open and/or tiny.
-        for (auto it = piece.begin(); it != piece.end(); ) {
-            if (!it->closed() || is_path_empty(*it)) {
-                it = piece.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        constexpr double expansion = 10.0;
+        bounds->expandBy(expansion);
 
-        // Skip empty pathvectors.
-        if (piece.empty()) {
-            continue;
-        }
+        auto bounds_pathv = Geom::PathVector(Geom::Path(*bounds));
+        auto pieces = pathvector_cut(bounds_pathv, lines);
 
-        // Determine the corresponding augmented item.
-        // Fixme: (Wishlist) This is done unreliably and hackily, but livarot/2geom seemingly offer no alternative.
-        std::unordered_map<PathvectorItem*, int> hits;
+        // No lines cross the inside of a piece, so the items covering a point well inside it cover all of it.
+        auto const grid = BoundsGrid(*bounds, rects, cluster);
 
-        auto rect = piece.boundsExact();
+        auto find_item = [&] (Geom::Point const &pt) -> PathvectorItem * {
+            for (auto i : grid.at(pt)) {
+                if (rects[i]->contains(pt)) {
+                    auto winding = augmented[i].pathv.winding(pt);
+                    if (nonzero[i] ? winding : winding % 2) {
+                        return &augmented[i];
+                    }
+                }
+            }
+            return nullptr;
+        };
 
-        auto add_hit = [&] (Geom::Point const &pt) {
-            // Find an augmented item containing the point.
-            for (auto &pvi : augmented) {
-                auto fill_rule = pvi.item->style->fill_rule.computed;
-                auto winding = pvi.pathv.winding(pt);
-                if (fill_rule == SP_WIND_RULE_NONZERO ? winding : winding % 2) {
-                    hits[&pvi]++;
-                    return;
+        for (auto &piece : pieces) {
+            // Skip the big enclosing piece that is touching the outer boundary.
+            if (auto rect = piece.boundsExact()) {
+                if (   Geom::are_near(rect->top(), bounds->top(), expansion / 2)
+                    || Geom::are_near(rect->bottom(), bounds->bottom(), expansion / 2)
+                    || Geom::are_near(rect->left(), bounds->left(), expansion / 2)
+                    || Geom::are_near(rect->right(), bounds->right(), expansion / 2))
+                {
+                    continue;
                 }
             }
 
-            // If none exists, register a background hit with nullptr.
-            hits[nullptr]++;
-        };
+            // Remove junk paths that are open and/or tiny.
+            for (auto it = piece.begin(); it != piece.end(); ) {
+                if (!it->closed() || is_path_empty(*it)) {
+                    it = piece.erase(it);
+                } else {
+                    ++it;
+                }
+            }
 
-        for (int total_hits = 0, patience = 1000; total_hits < 20 && patience > 0; patience--) {
-            // Attempt to generate a point strictly inside the piece.
-            auto pt = rect->min() + randpt() * rect->dimensions();
-            if (piece.winding(pt)) {
-                add_hit(pt);
-                total_hits++;
+            // Skip empty pathvectors.
+            if (piece.empty()) {
+                continue;
             }
-        }
 
-        // Pick the augmented item with the most hits.
-        PathvectorItem *found = nullptr;
-        int max_hits = 0;
+            // Determine the corresponding augmented item, letting a few interior points vote
+            // in case one of them lands on an edge.
+            std::unordered_map<PathvectorItem*, int> hits;
+            for (auto &pt : interior_points(piece, *piece.boundsExact())) {
+                hits[find_item(pt)]++;
+            }
 
-        for (auto &[a, h] : hits) {
-            if (h > max_hits) {
-                max_hits = h;
-                found = a;
+            // Pick the augmented item with the most hits, preferring the topmost on ties.
+            PathvectorItem *found = nullptr;
+            int max_hits = 0;
+
+            for (auto &[a, h] : hits) {
+                if (h > max_hits || (h == max_hits && a && (!found || a < found))) {
+                    max_hits = h;
+                    found = a;
+                }
             }
+
+            cluster_pieces[c].emplace_back(std::move(piece), found);
         }
+    });
 
-        // Add the SubItem.
-        auto root = found ? found->root : nullptr;
-        auto item = found ? found->item : nullptr;
-        auto style = item ? item->style : nullptr;
-        result.emplace_back(std::make_shared<SubItem>(std::move(piece), root, item, style));
+    // Construct the SubItems.
+    WorkItems result;
+
+    for (auto &pieces : cluster_pieces) {
+        for (auto &[piece, found] : pieces) {
+            auto root = found ? found->root : nullptr;
+            auto item = found ? found->item : nullptr;
+            auto style = item ? item->style : nullptr;
+            result.emplace_back(std::make_shared<SubItem>(std::move(piece), root, item, style));
+        }
     }
 
     return result;
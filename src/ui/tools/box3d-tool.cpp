@@ -129,7 +129,7 @@ bool Box3dTool::root_handler(CanvasEvent const &event)
 
     auto prefs = Preferences::get();
     int const snaps = prefs->getInt("/options/rotationsnapsperpi/value", 12);
-    tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+    tolerance = _drag_tolerance;
 
     auto cur_persp = document->getCurrentPersp3D();
 
@@ -20,9 +20,16 @@
 
 #include "flood-tool.h"
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
 #include <cstdint>
 #include <queue>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 #include <gdk/gdkkeysyms.h>
 #include <glibmm/i18n.h>
@@ -301,6 +308,53 @@ struct BitmapCoordsInfo
     unsigned int current_step;
 };
 
+/**
+ * A set of pixels of the rendered area, stored as one bit per pixel.
+ */
+class PixelMask
+{
+public:
+    PixelMask(unsigned width, unsigned height)
+        : _words_per_row((width + 63) / 64)
+        , _words(_words_per_row * height)
+    {}
+
+    bool test(unsigned x, unsigned y) const { return (_words[y * _words_per_row + x / 64] >> (x % 64)) & 1; }
+    void set(unsigned x, unsigned y) { _words[y * _words_per_row + x / 64] |= std::uint64_t{1} << (x % 64); }
+
+    /// Add the pixels from x0 to x1 inclusive on row y.
+    void set_span(unsigned x0, unsigned x1, unsigned y)
+    {
+        auto const row = _words.data() + y * _words_per_row;
+        unsigned const w0 = x0 / 64, w1 = x1 / 64;
+        auto const head = ~std::uint64_t{0} << (x0 % 64);
+        auto const tail = ~std::uint64_t{0} >> (63 - x1 % 64);
+        if (w0 == w1) {
+            row[w0] |= head & tail;
+            return;
+        }
+        row[w0] |= head;
+        std::fill(row + w0 + 1, row + w1, ~std::uint64_t{0});
+        row[w1] |= tail;
+    }
+
+    void clear() { std::fill(_words.begin(), _words.end(), 0); }
+
+    /// The number of pixels in the set.
+    std::size_t count() const
+    {
+        std::size_t n = 0;
+        for (auto word : _words) {
+            n += std::popcount(word);
+        }
+        return n;
+    }
+
+private:
+    unsigned _words_per_row;
+    std::vector<std::uint64_t> _words;
+};
+
 /**
  * Check if a pixel can be included in the fill.
  * @param px The rendered pixel buffer to check.
@@ -328,27 +382,23 @@ inline static bool check_if_pixel_is_paintable(unsigned char *px, unsigned char
 
 /**
  * Perform the bitmap-to-vector tracing and place the traced path onto the document.
- * @param px The trace pixel buffer to trace to SVG.
+ * @param filled The filled pixels to trace to SVG.
  * @param desktop The desktop on which to place the final SVG path.
  * @param transform The transform to apply to the final SVG path.
  * @param union_with_selection If true, merge the final SVG path with the current selection.
  */
-static void do_trace(BitmapCoordsInfo const &bci, unsigned char *trace_px, SPDesktop *desktop, Geom::Affine const &transform, unsigned min_x, unsigned max_x, unsigned min_y, unsigned max_y, bool union_with_selection)
+static void do_trace(PixelMask const &filled, SPDesktop *desktop, Geom::Affine const &transform, unsigned min_x, unsigned max_x, unsigned min_y, unsigned max_y, bool union_with_selection)
 {
     SPDocument *document = desktop->getDocument();
 
-    unsigned char *trace_t;
-
     auto gray_map = Trace::GrayMap(max_x - min_x + 1, max_y - min_y + 1);
     unsigned gray_map_y = 0;
     for (unsigned y = min_y; y <= max_y; y++) {
         auto gray_map_t = gray_map.row(gray_map_y);
 
-        trace_t = get_trace_pixel(trace_px, min_x, y, bci.width);
         for (unsigned x = min_x; x <= max_x; x++) {
-            *gray_map_t = is_pixel_colored(trace_t) ? Trace::GrayMap::BLACK : Trace::GrayMap::WHITE;
+            *gray_map_t = filled.test(x, y) ? Trace::GrayMap::BLACK : Trace::GrayMap::WHITE;
             gray_map_t++;
-            trace_t++;
         }
         gray_map_y++;
     }
@@ -579,8 +629,6 @@ static ScanlineCheckResult perform_bitmap_scanline_check(std::deque<Geom::Point>
     bool can_paint_top = (top_ty > 0);
     bool can_paint_bottom = (bottom_ty < bci.height);
 
-    Geom::Point front_of_queue = fill_queue.empty() ? Geom::Point() : fill_queue.front();
-
     do {
         ok = false;
         if (bci.is_left) {
@@ -595,13 +643,6 @@ static ScanlineCheckResult perform_bitmap_scanline_check(std::deque<Geom::Point>
         if (keep_tracing) {
             if (check_if_pixel_is_paintable(px, current_trace_t, bci.x, bci.y, orig_color, bci)) {
                 paint_directions = paint_pixel(px, trace_px, orig_color, bci, current_trace_t);
-                if (bci.radius == 0) {
-                    mark_pixel_checked(current_trace_t);
-                    if (!fill_queue.empty() && front_of_queue == Geom::IntPoint(bci.x, bci.y)) {
-                        fill_queue.pop_front();
-                        front_of_queue = fill_queue.empty() ? Geom::Point() : fill_queue.front();
-                    }
-                }
 
                 if (can_paint_top) {
                     if (paint_directions & PAINT_DIRECTION_UP) { 
@@ -670,177 +711,164 @@ static ScanlineCheckResult perform_bitmap_scanline_check(std::deque<Geom::Point>
 }
 
 /**
- * Sort the rendered pixel buffer check queue vertically.
+ * Report whether filling a span touches the edge of the rendered area, and if so, whether the fill
+ * has escaped the drawing and so is unbounded.
  */
-static bool sort_fill_queue_vertical(Geom::Point const &a, Geom::Point const &b)
+static ScanlineCheckResult check_span_boundary(unsigned x0, unsigned x1, unsigned y, BitmapCoordsInfo const &bci)
 {
-    return a.y() > b.y();
-}
-
-/**
- * Sort the rendered pixel buffer check queue horizontally.
- */
-static bool sort_fill_queue_horizontal(Geom::Point const &a, Geom::Point const &b)
-{
-    return a.x() > b.x();
+    auto result = ScanlineCheckResult::OK;
+    auto check = [&] (bool at_edge, bool drawing_inside) {
+        if (at_edge && result != ScanlineCheckResult::ABORTED) {
+            result = drawing_inside ? ScanlineCheckResult::ABORTED : ScanlineCheckResult::BOUNDARY;
+        }
+    };
+    check(x0 == 0,                 bci.bbox.min()[Geom::X] > bci.screen.min()[Geom::X]);
+    check(x1 == bci.width - 1,     bci.bbox.max()[Geom::X] < bci.screen.max()[Geom::X]);
+    check(y == 0,                  bci.bbox.min()[Geom::Y] > bci.screen.min()[Geom::Y]);
+    check(y == bci.height - 1,     bci.bbox.max()[Geom::Y] < bci.screen.max()[Geom::Y]);
+    return result;
 }
 
 /**
- * Perform a flood fill operation.
- * @param desktop The desktop of this tool's event context.
- * @param cursor_pos The location of the mouse cursor.
- * @param union_with_selection If true, union the new fill with the current selection.
- * @param is_point_fill If false, use the Rubberband "touch selection" to get the initial points for the fill.
- * @param is_touch_fill If true, use only the initial contact point in the Rubberband "touch selection" as the fill target color.
+ * Flood fill the rendered pixel buffer one horizontal span at a time.
+ *
+ * Each fill point in turn picks the target color, unless touch filling, where the first one picks it for all.
+ * Paintability is evaluated at most once per pixel and target color, and cached in bitsets.
+ *
+ * @param points The fill points, in image coordinates.
+ * @param is_touch_fill If true, use only the first point as the fill target color.
+ * @param px The rendered pixel buffer.
+ * @param bci The bitmap_coords_info structure.
+ * @param filled The filled pixels.
  */
-static void sp_flood_do_flood_fill(SPDesktop *desktop, Geom::Point const &cursor_pos,
-                                   bool union_with_selection, bool is_point_fill, bool is_touch_fill)
+static ScanlineCheckResult span_fill(std::vector<Geom::IntPoint> const &points, bool is_touch_fill, unsigned char *px, BitmapCoordsInfo &bci, PixelMask &filled, unsigned &min_x, unsigned &max_x, unsigned &min_y, unsigned &max_y)
 {
-    auto const document = desktop->getDocument();
-    document->ensureUpToDate();
-    
-    auto const bbox = document->getRoot()->visualBounds();
-    if (!bbox) {
-        desktop->messageStack()->flash(Inkscape::WARNING_MESSAGE, _("<b>Area is not bounded</b>, cannot fill."));
-        return;
-    }
-    
-    // Render 160% of the physical display to the render pixel buffer, so that available
-    // fill areas off the screen can be included in the fill.
-    constexpr double padding = 1.6;
-
-    // image space is world space with an offset
-    Geom::Rect const screen_world = desktop->getCanvas()->get_area_world();
-    Geom::Rect const screen = screen_world * desktop->w2d();
-    Geom::IntPoint const img_dims = (screen_world.dimensions() * padding).ceil();
-    Geom::Affine const world2img = Geom::Translate((img_dims - screen_world.dimensions()) / 2.0 - screen_world.min());
-    Geom::Affine const doc2img = desktop->doc2dt() * desktop->d2w() * world2img;
+    auto tested = PixelMask(bci.width, bci.height);
+    auto paintable = PixelMask(bci.width, bci.height);
+    uint32_t orig_color = 0;
+
+    auto is_paintable = [&] (unsigned x, unsigned y) {
+        if (!tested.test(x, y)) {
+            tested.set(x, y);
+            if (compare_pixels(get_pixel(px, x, y, bci.stride), orig_color, bci.merged_orig_pixel, bci.dtc, bci.threshold, bci.method)) {
+                paintable.set(x, y);
+            }
+        }
+        return paintable.test(x, y);
+    };
 
-    auto const width = img_dims.x();
-    auto const height = img_dims.y();
+    auto can_fill = [&] (unsigned x, unsigned y) {
+        return !filled.test(x, y) && is_paintable(x, y);
+    };
 
-    auto const stride = Cairo::ImageSurface::format_stride_for_width(Cairo::Surface::Format::ARGB32, width);
-    // TODO: C++20: *once* Apple+AppImage support it: Use std::make_unique_for_overwrite()
-    auto const px = std::make_unique<unsigned char[]>(stride * height);
-    uint32_t dtc;
+    auto result = ScanlineCheckResult::OK;
+    std::vector<Geom::IntPoint> seeds;
 
-    // Draw image into data block px
-    { // this block limits the lifetime of Drawing and DrawingContext
-        // Create DrawingItems and set transform.
-        Drawing drawing;
-        unsigned dkey = SPItem::display_key_new(1);
-        auto root = document->getRoot()->invoke_show(drawing, dkey, SP_ITEM_SHOW_DISPLAY);
-        root->setTransform(doc2img);
-        drawing.setRoot(root);
-
-        auto const final_bbox = Geom::IntRect::from_xywh(0, 0, width, height);
-        drawing.update(final_bbox);
+    for (unsigned i = 0; i < points.size(); i++) {
+        if (!is_touch_fill || i == 0) {
+            auto const &color_point = points[i];
+            if (filled.test(color_point.x(), color_point.y())) {
+                continue;
+            }
+            orig_color = get_pixel(px, color_point.x(), color_point.y(), bci.stride);
+            bci.merged_orig_pixel = compose_onto(orig_color, bci.dtc);
+            tested.clear();
+            paintable.clear();
+        }
 
-        auto surf = Cairo::ImageSurface::create(px.get(), Cairo::Surface::Format::ARGB32, width, height, stride);
-        auto dc = DrawingContext(surf->cobj(), Geom::Point());
-        // cairo_translate not necessary here - surface origin is at 0,0
+        seeds.push_back(points[i]);
+        if (is_touch_fill && i + 1 < points.size()) {
+            continue; // Fill from all the touched points at once.
+        }
 
-        // make color transparent for 'alpha' flood mode to work
-        auto bgcolor = document->getPageManager().getBackgroundColor();
-        bgcolor.setOpacity(0.0);
+        while (!seeds.empty()) {
+            int const x = seeds.back().x();
+            int const y = seeds.back().y();
+            seeds.pop_back();
 
-        dc.setSource(bgcolor.toARGB());
-        dc.setOperator(CAIRO_OPERATOR_SOURCE);
-        dc.paint();
-        dc.setOperator(CAIRO_OPERATOR_OVER);
+            if (!can_fill(x, y)) {
+                continue;
+            }
 
-        drawing.render(dc, final_bbox);
+            // Extend the span as far as possible either side of the seed.
+            unsigned x0 = x;
+            unsigned x1 = x;
+            while (x0 > 0 && can_fill(x0 - 1, y)) {
+                x0--;
+            }
+            while (x1 + 1 < bci.width && can_fill(x1 + 1, y)) {
+                x1++;
+            }
 
-        if constexpr (false) surf->write_to_png("cairo.png");
+            filled.set_span(x0, x1, y);
+            min_x = std::min(min_x, x0);
+            max_x = std::max(max_x, x1);
+            min_y = std::min<unsigned>(min_y, y);
+            max_y = std::max<unsigned>(max_y, y);
+
+            switch (check_span_boundary(x0, x1, y, bci)) {
+                case ScanlineCheckResult::ABORTED:
+                    return ScanlineCheckResult::ABORTED;
+                case ScanlineCheckResult::BOUNDARY:
+                    result = ScanlineCheckResult::BOUNDARY;
+                    break;
+                default:
+                    break;
+            }
 
-        surf->flush();
-        
-        // Hide items
-        document->getRoot()->invoke_hide(dkey);
+            // Seed the start of each fillable run in the rows above and below.
+            for (int ny : {y - 1, y + 1}) {
+                if (ny < 0 || ny >= (int)bci.height) {
+                    continue;
+                }
+                bool in_run = false;
+                for (unsigned nx = x0; nx <= x1; nx++) {
+                    bool const fillable = can_fill(nx, ny);
+                    if (fillable && !in_run) {
+                        seeds.emplace_back(nx, ny);
+                    }
+                    in_run = fillable;
+                }
+            }
+        }
     }
 
-    if constexpr (false) {
-        // Dump data to png
-        auto surf = Cairo::ImageSurface::create(px.get(), Cairo::Surface::Format::ARGB32, width, height, stride);
-        surf->write_to_png("cairo2.png");
-        std::cout << "  Wrote cairo2.png" << std::endl;
-    }
+    return result;
+}
+
+/**
+ * Flood fill the rendered pixel buffer with autogap, closing gaps narrower than bci.radius.
+ *
+ * @param points The fill points, in image coordinates.
+ * @param is_touch_fill If true, use only the first point as the fill target color.
+ * @param px The rendered pixel buffer.
+ * @param bci The bitmap_coords_info structure.
+ * @param filled The filled pixels.
+ */
+static ScanlineCheckResult autogap_fill(std::vector<Geom::IntPoint> const &points, bool is_touch_fill, unsigned char *px, BitmapCoordsInfo &bci, PixelMask &filled, unsigned &min_x, unsigned &max_x, unsigned &min_y, unsigned &max_y)
+{
+    auto const width = bci.width;
+    auto const height = bci.height;
 
     auto const trace_px = std::make_unique<unsigned char[]>(width * height);
-    
+
     std::deque<Geom::Point> fill_queue;
     std::queue<Geom::Point> color_queue;
-    
-    bool aborted = false;
-    int y_limit = height - 1;
-
-    auto prefs = Preferences::get();
-    auto const method = static_cast<PaintBucketChannels>(prefs->getInt("/tools/paintbucket/channels", 0));
-    int threshold = prefs->getIntLimited("/tools/paintbucket/threshold", 1, 0, 100);
 
-    switch (method) {
-        case FLOOD_CHANNELS_ALPHA:
-        case FLOOD_CHANNELS_RGB:
-        case FLOOD_CHANNELS_R:
-        case FLOOD_CHANNELS_G:
-        case FLOOD_CHANNELS_B:
-            threshold = (255 * threshold) / 100;
-            break;
-        default:
-            break;
-    }
-
-    BitmapCoordsInfo bci;
-    
-    bci.y_limit = y_limit;
-    bci.width = width;
-    bci.height = height;
-    bci.stride = stride;
-    bci.threshold = threshold;
-    bci.method = method;
-    bci.bbox = *bbox;
-    bci.screen = screen;
-    bci.dtc = dtc;
-    bci.radius = prefs->getIntLimited("/tools/paintbucket/autogap", 0, 0, 3);
-    bci.max_queue_size = (width * height) / 4;
-    bci.current_step = 0;
-
-    auto const fill_points = [&] () -> std::vector<Geom::Point> {
-        if (is_point_fill) {
-            return { cursor_pos };
-        } else {
-            return Rubberband::get(desktop)->getPoints();
-        }
-    }();
-
-    auto const img_max_indices = Geom::Rect::from_xywh(0, 0, width - 1, height - 1);
-
-    for (unsigned i = 0; i < fill_points.size(); i++) {
-        auto const pw = img_max_indices.clamp(fill_points[i] * world2img);
-
-        if (is_touch_fill) {
-            if (i == 0) {
-                color_queue.emplace(pw);
-            } else {
-                auto trace_t = get_trace_pixel(trace_px.get(), (int)pw.x(), (int)pw.y(), width);
-                push_point_onto_queue(fill_queue, bci.max_queue_size, trace_t, (int)pw.x(), (int)pw.y());
-            }
+    for (unsigned i = 0; i < points.size(); i++) {
+        auto const &pw = points[i];
+        if (is_touch_fill && i != 0) {
+            auto trace_t = get_trace_pixel(trace_px.get(), pw.x(), pw.y(), width);
+            push_point_onto_queue(fill_queue, bci.max_queue_size, trace_t, pw.x(), pw.y());
         } else {
             color_queue.emplace(pw);
         }
     }
 
+    bool aborted = false;
     bool reached_screen_boundary = false;
-
     bool first_run = true;
 
-    size_t sort_size_threshold = 5;
-
-    unsigned int min_y = height;
-    unsigned int max_y = 0;
-    unsigned int min_x = width;
-    unsigned int max_x = 0;
-
     while (!color_queue.empty() && !aborted) {
         Geom::Point color_point = color_queue.front();
         color_queue.pop();
@@ -848,12 +876,12 @@ static void sp_flood_do_flood_fill(SPDesktop *desktop, Geom::Point const &cursor
         int cx = (int)color_point[Geom::X];
         int cy = (int)color_point[Geom::Y];
 
-        uint32_t orig_color = get_pixel(px.get(), cx, cy, stride);
-        bci.merged_orig_pixel = compose_onto(orig_color, dtc);
+        uint32_t orig_color = get_pixel(px, cx, cy, bci.stride);
+        bci.merged_orig_pixel = compose_onto(orig_color, bci.dtc);
 
         unsigned char *trace_t = get_trace_pixel(trace_px.get(), cx, cy, width);
         if (!is_pixel_checked(trace_t) && !is_pixel_colored(trace_t)) {
-            if (check_if_pixel_is_paintable(px.get(), trace_px.get(), cx, cy, orig_color, bci)) {
+            if (check_if_pixel_is_paintable(px, trace_t, cx, cy, orig_color, bci)) {
                 shift_point_onto_queue(fill_queue, bci.max_queue_size, trace_t, cx, cy);
 
                 if (!first_run) {
@@ -869,54 +897,8 @@ static void sp_flood_do_flood_fill(SPDesktop *desktop, Geom::Point const &cursor
             }
         }
 
-        unsigned long old_fill_queue_size = fill_queue.size();
-
         while (!fill_queue.empty() && !aborted) {
             Geom::Point cp = fill_queue.front();
-
-            if (bci.radius == 0) {
-                auto const new_fill_queue_size = fill_queue.size();
-
-                /*
-                 * To reduce the number of points in the fill queue, periodically
-                 * resort all of the points in the queue so that scanline checks
-                 * can complete more quickly.  A point cannot be checked twice
-                 * in a normal scanline checks, so forcing scanline checks to start
-                 * from one corner of the rendered area as often as possible
-                 * will reduce the number of points that need to be checked and queued.
-                 */
-                if (new_fill_queue_size > sort_size_threshold) {
-                    if (new_fill_queue_size > old_fill_queue_size) {
-                        std::sort(fill_queue.begin(), fill_queue.end(), sort_fill_queue_vertical);
-
-                        auto start_sort = fill_queue.begin();
-                        auto end_sort = fill_queue.begin();
-                        unsigned int sort_y = (unsigned int)cp[Geom::Y];
-                        unsigned int current_y;
-                        
-                        for (auto i = fill_queue.begin(); i != fill_queue.end(); ++i) {
-                            Geom::Point current = *i;
-                            current_y = (unsigned int)current[Geom::Y];
-                            if (current_y != sort_y) {
-                                if (start_sort != end_sort) {
-                                    std::sort(start_sort, end_sort, sort_fill_queue_horizontal);
-                                }
-                                sort_y = current_y;
-                                start_sort = i;
-                            }
-                            end_sort = i;
-                        }
-                        if (start_sort != end_sort) {
-                            std::sort(start_sort, end_sort, sort_fill_queue_horizontal);
-                        }
-                        
-                        cp = fill_queue.front();
-                    }
-                }
-
-                old_fill_queue_size = new_fill_queue_size;
-            }
-
             fill_queue.pop_front();
 
             int x = (int)cp[Geom::X];
@@ -930,15 +912,15 @@ static void sp_flood_do_flood_fill(SPDesktop *desktop, Geom::Point const &cursor
                 mark_pixel_checked(trace_t);
 
                 if (y == 0) {
-                    if (bbox->min()[Geom::Y] > screen.min()[Geom::Y]) {
+                    if (bci.bbox.min()[Geom::Y] > bci.screen.min()[Geom::Y]) {
                         aborted = true; break;
                     } else {
                         reached_screen_boundary = true;
                     }
                 }
 
-                if (y == y_limit) {
-                    if (bbox->max()[Geom::Y] < screen.max()[Geom::Y]) {
+                if (y == bci.y_limit) {
+                    if (bci.bbox.max()[Geom::Y] < bci.screen.max()[Geom::Y]) {
                         aborted = true; break;
                     } else {
                         reached_screen_boundary = true;
@@ -949,7 +931,7 @@ static void sp_flood_do_flood_fill(SPDesktop *desktop, Geom::Point const &cursor
                 bci.x = x;
                 bci.y = y;
 
-                ScanlineCheckResult result = perform_bitmap_scanline_check(fill_queue, px.get(), trace_px.get(), orig_color, bci, &min_x, &max_x);
+                ScanlineCheckResult result = perform_bitmap_scanline_check(fill_queue, px, trace_px.get(), orig_color, bci, &min_x, &max_x);
 
                 switch (result) {
                     case ScanlineCheckResult::ABORTED:
@@ -969,7 +951,7 @@ static void sp_flood_do_flood_fill(SPDesktop *desktop, Geom::Point const &cursor
                         bci.is_left = false;
                         bci.x = x + 1;
 
-                        result = perform_bitmap_scanline_check(fill_queue, px.get(), trace_px.get(), orig_color, bci, &min_x, &max_x);
+                        result = perform_bitmap_scanline_check(fill_queue, px, trace_px.get(), orig_color, bci, &min_x, &max_x);
 
                         switch (result) {
                             case ScanlineCheckResult::ABORTED:
@@ -992,12 +974,223 @@ static void sp_flood_do_flood_fill(SPDesktop *desktop, Geom::Point const &cursor
             }
         }
     }
-    
+
     if (aborted) {
+        return ScanlineCheckResult::ABORTED;
+    }
+
+    for (unsigned y = min_y; y <= max_y && y < height; y++) {
+        auto trace_t = get_trace_pixel(trace_px.get(), 0, y, width);
+        for (unsigned x = 0; x < width; x++) {
+            if (is_pixel_colored(trace_t + x)) {
+                filled.set(x, y);
+            }
+        }
+    }
+
+    return reached_screen_boundary ? ScanlineCheckResult::BOUNDARY : ScanlineCheckResult::OK;
+}
+
+long flood_fill_bitmap(unsigned char *px, int width, int height, int stride, Geom::IntPoint const &point,
+                       PaintBucketChannels method, int threshold, bool queue)
+{
+    // The whole bitmap is the visible area, so a fill that reaches its edges is cut off there.
+    auto const area = Geom::Rect(0, 0, width, height);
+
+    BitmapCoordsInfo bci{};
+    bci.y_limit = height - 1;
+    bci.width = width;
+    bci.height = height;
+    bci.stride = stride;
+    bci.threshold = threshold;
+    bci.method = method;
+    bci.bbox = area;
+    bci.screen = area;
+    bci.radius = 0;
+    bci.max_queue_size = (width * height) / 4;
+
+    unsigned min_y = height;
+    unsigned max_y = 0;
+    unsigned min_x = width;
+    unsigned max_x = 0;
+
+    auto filled = PixelMask(width, height);
+    auto const result = queue
+        ? autogap_fill({point}, false, px, bci, filled, min_x, max_x, min_y, max_y)
+        : span_fill({point}, false, px, bci, filled, min_x, max_x, min_y, max_y);
+
+    return result == ScanlineCheckResult::ABORTED ? -1 : filled.count();
+}
+
+/**
+ * Perform a flood fill operation.
+ * @param desktop The desktop of this tool's event context.
+ * @param cursor_pos The location of the mouse cursor.
+ * @param union_with_selection If true, union the new fill with the current selection.
+ * @param is_point_fill If false, use the Rubberband "touch selection" to get the initial points for the fill.
+ * @param is_touch_fill If true, use only the initial contact point in the Rubberband "touch selection" as the fill target color.
+ */
+static void sp_flood_do_flood_fill(SPDesktop *desktop, Geom::Point const &cursor_pos,
+                                   bool union_with_selection, bool is_point_fill, bool is_touch_fill)
+{
+    auto const document = desktop->getDocument();
+    document->ensureUpToDate();
+    
+    auto const bbox = document->getRoot()->visualBounds();
+    if (!bbox) {
         desktop->messageStack()->flash(Inkscape::WARNING_MESSAGE, _("<b>Area is not bounded</b>, cannot fill."));
         return;
     }
     
+    // Render 160% of the physical display to the render pixel buffer, so that available
+    // fill areas off the screen can be included in the fill.
+    constexpr double padding = 1.6;
+
+    // image space is world space with an offset
+    Geom::Rect const screen_world = desktop->getCanvas()->get_area_world();
+    Geom::Rect const screen = screen_world * desktop->w2d();
+    Geom::IntPoint const img_dims = (screen_world.dimensions() * padding).ceil();
+    Geom::Affine const world2img = Geom::Translate((img_dims - screen_world.dimensions()) / 2.0 - screen_world.min());
+    Geom::Affine const doc2img = desktop->doc2dt() * desktop->d2w() * world2img;
+
+    auto const width = img_dims.x();
+    auto const height = img_dims.y();
+
+    auto const stride = Cairo::ImageSurface::format_stride_for_width(Cairo::Surface::Format::ARGB32, width);
+    // TODO: C++20: *once* Apple+AppImage support it: Use std::make_unique_for_overwrite()
+    auto const px = std::make_unique<unsigned char[]>(stride * height);
+    uint32_t dtc;
+
+    // Draw image into data block px
+    { // this block limits the lifetime of Drawing and DrawingContext
+        // Create DrawingItems and set transform.
+        Drawing drawing;
+        unsigned dkey = SPItem::display_key_new(1);
+        auto root = document->getRoot()->invoke_show(drawing, dkey, SP_ITEM_SHOW_DISPLAY);
+        root->setTransform(doc2img);
+        drawing.setRoot(root);
+
+        auto const final_bbox = Geom::IntRect::from_xywh(0, 0, width, height);
+        drawing.update(final_bbox);
+
+        // make color transparent for 'alpha' flood mode to work
+        auto bgcolor = document->getPageManager().getBackgroundColor();
+        bgcolor.setOpacity(0.0);
+
+        // Render horizontal bands concurrently, as the canvas does with its tiles. This uses its own threads
+        // rather than the dispatch pool, since filters dispatch work onto that while rendering.
+        auto render_band = [&] (int y0, int y1) {
+            auto surf = Cairo::ImageSurface::create(px.get() + y0 * stride, Cairo::Surface::Format::ARGB32, width, y1 - y0, stride);
+            auto dc = DrawingContext(surf->cobj(), Geom::Point(0, y0));
+
+            dc.setSource(bgcolor.toARGB());
+            dc.setOperator(CAIRO_OPERATOR_SOURCE);
+            dc.paint();
+            dc.setOperator(CAIRO_OPERATOR_OVER);
+
+            drawing.render(dc, Geom::IntRect(0, y0, width, y1));
+
+            surf->flush();
+        };
+
+        int const numthreads = std::max<int>(std::thread::hardware_concurrency(), 1);
+        int const numbands = std::clamp(height / 64, 1, numthreads);
+        if (numbands == 1) {
+            render_band(0, height);
+        } else {
+            boost::asio::thread_pool pool(numbands);
+            for (int i = 0; i < numbands; i++) {
+                boost::asio::post(pool, [&, i] { render_band(height * i / numbands, height * (i + 1) / numbands); });
+            }
+            pool.join();
+        }
+
+        if constexpr (false) {
+            auto surf = Cairo::ImageSurface::create(px.get(), Cairo::Surface::Format::ARGB32, width, height, stride);
+            surf->write_to_png("cairo.png");
+        }
+
+        // Hide items
+        document->getRoot()->invoke_hide(dkey);
+    }
+
+    if constexpr (false) {
+        // Dump data to png
+        auto surf = Cairo::ImageSurface::create(px.get(), Cairo::Surface::Format::ARGB32, width, height, stride);
+        surf->write_to_png("cairo2.png");
+        std::cout << "  Wrote cairo2.png" << std::endl;
+    }
+
+    int y_limit = height - 1;
+
+    auto prefs = Preferences::get();
+    auto const method = static_cast<PaintBucketChannels>(prefs->getInt("/tools/paintbucket/channels", 0));
+    int threshold = prefs->getIntLimited("/tools/paintbucket/threshold", 1, 0, 100);
+
+    switch (method) {
+        case FLOOD_CHANNELS_ALPHA:
+        case FLOOD_CHANNELS_RGB:
+        case FLOOD_CHANNELS_R:
+        case FLOOD_CHANNELS_G:
+        case FLOOD_CHANNELS_B:
+            threshold = (255 * threshold) / 100;
+            break;
+        default:
+            break;
+    }
+
+    BitmapCoordsInfo bci;
+    
+    bci.y_limit = y_limit;
+    bci.width = width;
+    bci.height = height;
+    bci.stride = stride;
+    bci.threshold = threshold;
+    bci.method = method;
+    bci.bbox = *bbox;
+    bci.screen = screen;
+    bci.dtc = dtc;
+    bci.radius = prefs->getIntLimited("/tools/paintbucket/autogap", 0, 0, 3);
+    bci.max_queue_size = (width * height) / 4;
+    bci.current_step = 0;
+
+    auto const fill_points = [&] () -> std::vector<Geom::Point> {
+        if (is_point_fill) {
+            return { cursor_pos };
+        } else {
+            return Rubberband::get(desktop)->getPoints();
+        }
+    }();
+
+    auto const img_max_indices = Geom::Rect::from_xywh(0, 0, width - 1, height - 1);
+
+    std::vector<Geom::IntPoint> img_points;
+    img_points.reserve(fill_points.size());
+    for (auto const &fill_point : fill_points) {
+        auto const pw = img_max_indices.clamp(fill_point * world2img);
+        img_points.emplace_back((int)pw.x(), (int)pw.y());
+    }
+
+    unsigned int min_y = height;
+    unsigned int max_y = 0;
+    unsigned int min_x = width;
+    unsigned int max_x = 0;
+
+    auto filled = PixelMask(width, height);
+    auto const result = bci.radius == 0
+        ? span_fill(img_points, is_touch_fill, px.get(), bci, filled, min_x, max_x, min_y, max_y)
+        : autogap_fill(img_points, is_touch_fill, px.get(), bci, filled, min_x, max_x, min_y, max_y);
+
+    if (result == ScanlineCheckResult::ABORTED) {
+        desktop->messageStack()->flash(Inkscape::WARNING_MESSAGE, _("<b>Area is not bounded</b>, cannot fill."));
+        return;
+    }
+
+    bool const reached_screen_boundary = result == ScanlineCheckResult::BOUNDARY;
+    if (min_x > max_x || min_y > max_y) {
+        return; // Nothing filled.
+    }
+
     if (reached_screen_boundary) {
         desktop->messageStack()->flash(Inkscape::WARNING_MESSAGE, _("<b>Only the visible part of the bounded area was filled.</b> If you want to fill all of the area, undo, zoom out, and fill again.")); 
     }
@@ -1010,7 +1203,7 @@ static void sp_flood_do_flood_fill(SPDesktop *desktop, Geom::Point const &cursor
 
     Geom::Affine inverted_affine = Geom::Translate(min_x, min_y) * doc2img.inverse();
     
-    do_trace(bci, trace_px.get(), desktop, inverted_affine, min_x, max_x, min_y, max_y, union_with_selection);
+    do_trace(filled, desktop, inverted_affine, min_x, max_x, min_y, max_y, union_with_selection);
     
     DocumentUndo::done(document, _("Fill bounded area"), INKSCAPE_ICON("color-fill"));
 }
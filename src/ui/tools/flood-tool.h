@@ -14,6 +14,7 @@
 
 #include <vector>
 
+#include <2geom/int-point.h>
 #include <sigc++/connection.h>
 
 #include "ui/tools/tool-base.h"
@@ -57,6 +58,15 @@ enum PaintBucketChannels
     FLOOD_CHANNELS_ALPHA
 };
 
+/**
+ * Flood fill a rendered ARGB32 bitmap from a point, as the tool fills the rendered canvas, and
+ * return the number of pixels filled, or -1 if the fill could not be bounded. With queue set, the
+ * queue based fill that autogap uses is run instead of the span fill, without closing any gaps.
+ * For the flood fill benchmark; the tool itself does not call it.
+ */
+long flood_fill_bitmap(unsigned char *px, int width, int height, int stride, Geom::IntPoint const &point,
+                       PaintBucketChannels method, int threshold, bool queue = false);
+
 } // namespace Inkscape::UI::Tools
 
 #endif // INKSCAPE_UI_TOOLS_FLOOD_TOOL_H
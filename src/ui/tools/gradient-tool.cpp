@@ -411,7 +411,7 @@ bool GradientTool::root_handler(CanvasEvent const &event)
     auto selection = _desktop->getSelection();
 
     auto prefs = Preferences::get();
-    tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+    tolerance = _drag_tolerance;
 
     bool ret = false;
 
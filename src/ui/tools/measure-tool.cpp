@@ -551,8 +551,7 @@ bool MeasureTool::root_handler(CanvasEvent const &event)
                 return;
             }
 
-            auto prefs = Preferences::get();
-            tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+            tolerance = _drag_tolerance;
 
             measure_item.clear();
 
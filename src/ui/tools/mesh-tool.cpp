@@ -434,9 +434,8 @@ Note: node/handle events are take care of elsewhere.
 bool MeshTool::root_handler(CanvasEvent const &event)
 {
     auto selection = _desktop->getSelection();
-    auto prefs = Inkscape::Preferences::get();
 
-    tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+    tolerance = _drag_tolerance;
 
     bool contains_mesh = false;
     if (!selection->isEmpty()) {
@@ -48,8 +48,7 @@ PagesTool::PagesTool(SPDesktop *desktop)
     desktop->getSelection()->setBackup();
     desktop->getSelection()->clear();
 
-    Inkscape::Preferences *prefs = Inkscape::Preferences::get();
-    drag_tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+    drag_tolerance = _drag_tolerance;
 
     if (resize_knots.empty()) {
         for (int i = 0; i < 4; i++) {
@@ -488,8 +488,7 @@ bool PenTool::_handleMotionNotify(MotionEvent const &event) {
     Geom::Point const event_w(event.pos);
 
     //we take out the function the const "tolerance" because we need it later
-    Inkscape::Preferences *prefs = Inkscape::Preferences::get();
-    gint const tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+    gint const tolerance = _drag_tolerance;
 
     if (pen_within_tolerance) {
         if ( Geom::LInfty( event_w - pen_drag_origin_w ) < tolerance ) {
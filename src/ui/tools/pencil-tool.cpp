@@ -265,9 +265,8 @@ bool PencilTool::_handleMotionNotify(MotionEvent const &event) {
     /* Find desktop coordinates */
     Geom::Point p = _desktop->w2d(event.pos);
 
-    Inkscape::Preferences *prefs = Inkscape::Preferences::get();
     if (pencil_within_tolerance) {
-        gint const tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+        gint const tolerance = _drag_tolerance;
         if ( Geom::LInfty(event.pos - pencil_drag_origin_w ) < tolerance ) {
             return false;   // Do not drag if we're within tolerance from origin.
         }
@@ -129,9 +129,8 @@ bool RectTool::item_handler(SPItem *item, CanvasEvent const &event)
 bool RectTool::root_handler(CanvasEvent const &event)
 {
     auto selection = _desktop->getSelection();
-    auto prefs = Inkscape::Preferences::get();
 
-    tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+    tolerance = _drag_tolerance;
 
     bool ret = false;
 
@@ -210,8 +210,7 @@ bool SelectTool::item_handler(SPItem *local_item, CanvasEvent const &event)
         sp_select_context_abort();
     }
 
-    auto *prefs = Inkscape::Preferences::get();
-    tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+    tolerance = _drag_tolerance;
 
     bool ret = false;
 
@@ -482,7 +481,7 @@ bool SelectTool::root_handler(CanvasEvent const &event)
                 _desktop->getSnapIndicator()->remove_snaptarget();
             }
 
-            tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+            tolerance = _drag_tolerance;
 
             bool first_hit = Modifier::get(Modifiers::Type::SELECT_FIRST_HIT)->active(button_press_state);
             bool force_drag = Modifier::get(Modifiers::Type::SELECT_FORCE_DRAG)->active(button_press_state);
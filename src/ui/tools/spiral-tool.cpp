@@ -116,9 +116,8 @@ void SpiralTool::set(const Inkscape::Preferences::Entry& val) {
 bool SpiralTool::root_handler(CanvasEvent const &event)
 {
     auto selection = _desktop->getSelection();
-    auto prefs = Inkscape::Preferences::get();
 
-    tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+    tolerance = _drag_tolerance;
 
     bool ret = false;
 
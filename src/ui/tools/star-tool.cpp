@@ -128,9 +128,8 @@ void StarTool::set(const Inkscape::Preferences::Entry& val) {
 bool StarTool::root_handler(CanvasEvent const &event)
 {
     auto selection = _desktop->getSelection();
-    auto prefs = Inkscape::Preferences::get();
 
-    tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+    tolerance = _drag_tolerance;
 
     bool ret = false;
 
@@ -373,7 +373,7 @@ bool TextTool::root_handler(CanvasEvent const &event)
     _validateCursorIterators();
 
     auto prefs = Preferences::get();
-    tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
+    tolerance = _drag_tolerance;
 
     bool ret = false;
 
@@ -336,9 +336,8 @@ bool ToolBase::root_handler(CanvasEvent const &event)
     auto prefs = Inkscape::Preferences::get();
 
     /// @todo Remove redundant /value in preference keys
-    // Todo: Make these into preference watchers, rather than fetching on every event.
-    tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
-    bool allow_panning = prefs->getBool("/options/spacebarpans/value");
+    tolerance = _drag_tolerance;
+    bool const allow_panning = _spacebar_pans;
     bool ret = false;
 
     auto compute_angle = [&] (Geom::Point const &pt) {
@@ -535,7 +534,7 @@ bool ToolBase::root_handler(CanvasEvent const &event)
     },
 
     [&] (ButtonReleaseEvent const &event) {
-        bool middle_mouse_zoom = prefs->getBool("/options/middlemousezoom/value");
+        bool const middle_mouse_zoom = _middle_mouse_zoom;
 
         xyp = {};
 
@@ -560,7 +559,7 @@ bool ToolBase::root_handler(CanvasEvent const &event)
             auto const event_w = event.pos;
             auto const event_dt = _desktop->w2d(event_w);
 
-            double const zoom_inc = prefs->getDoubleLimited("/options/zoomincrement/value", M_SQRT2, 1.01, 10);
+            double const zoom_inc = _zoom_increment;
 
             _desktop->zoom_relative(event_dt, (event.modifiers & GDK_SHIFT_MASK) ? 1 / zoom_inc : zoom_inc);
             ret = true;
@@ -592,8 +591,8 @@ bool ToolBase::root_handler(CanvasEvent const &event)
     },
 
     [&] (KeyPressEvent const &event) {
-        double const acceleration = prefs->getDoubleLimited("/options/scrollingacceleration/value", 0, 0, 6);
-        int const key_scroll = prefs->getIntLimited("/options/keyscroll/value", 10, 0, 1000);
+        double const acceleration = _scrolling_acceleration;
+        int const key_scroll = _key_scroll;
 
         if (_acc_quick_preview.isTriggeredBy(event)) {
             _desktop->quick_preview(true);
@@ -783,7 +782,7 @@ bool ToolBase::root_handler(CanvasEvent const &event)
 
     [&] (ScrollEvent const &event) {
         // Factor of 2 for legacy reasons: previously we did two wheel_scrolls for each mouse scroll.
-        auto get_scroll_inc = [&] { return prefs->getIntLimited("/options/wheelscroll/value", 40, 0, 1000) * 2; };
+        auto get_scroll_inc = [&] { return _wheel_scroll * 2; };
 
         using Modifiers::Type;
         using Modifiers::Triggers;
@@ -841,7 +840,7 @@ bool ToolBase::root_handler(CanvasEvent const &event)
 
             double scale;
             if (event.unit == Gdk::ScrollUnit::WHEEL) {
-                double const zoom_inc = prefs->getDoubleLimited("/options/zoomincrement/value", M_SQRT2, 1.01, 10);
+                double const zoom_inc = _zoom_increment;
                 scale = std::pow(zoom_inc, delta_y);
             } else {
                 scale = delta_y / 10; // logical pixels to scale, arbitrary
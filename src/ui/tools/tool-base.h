@@ -13,6 +13,7 @@
 #ifndef INKSCAPE_UI_TOOLS_TOOL_BASE_H
 #define INKSCAPE_UI_TOOLS_TOOL_BASE_H
 
+#include <cmath>
 #include <cstddef>
 #include <string>
 #include <memory>
@@ -133,6 +134,13 @@ private:
     std::unique_ptr<Preferences::PreferencesObserver> pref_observer;
     std::string _prefs_path;
 
+    // Global options consulted while handling canvas events, kept live to avoid a lookup per event.
+    Pref<bool> _spacebar_pans = {"/options/spacebarpans/value"};
+    Pref<bool> _middle_mouse_zoom = {"/options/middlemousezoom/value"};
+    Pref<double> _scrolling_acceleration = {"/options/scrollingacceleration/value", 0, 0, 6};
+    Pref<int> _key_scroll = {"/options/keyscroll/value", 10, 0, 1000};
+    Pref<int> _wheel_scroll = {"/options/wheelscroll/value", 40, 0, 1000};
+
     void set_on_buttons(CanvasEvent const &event);
     bool are_buttons_1_and_3_on() const;
     bool are_buttons_1_and_3_on(CanvasEvent const &event);
@@ -145,6 +153,8 @@ protected:
     Geom::IntPoint xyp;             ///< where drag started
     bool dragging = false;          ///< are we dragging?
     int tolerance = 0;
+    Pref<int> _drag_tolerance = {"/options/dragtolerance/value", 0, 0, 100};
+    Pref<double> _zoom_increment = {"/options/zoomincrement/value", M_SQRT2, 1.01, 10};
     bool within_tolerance = false;  ///< are we still within tolerance of origin
     bool _button1on = false;
     bool _button2on = false;
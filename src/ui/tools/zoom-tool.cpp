@@ -45,9 +45,8 @@ ZoomTool::~ZoomTool()
 
 bool ZoomTool::root_handler(CanvasEvent const &event)
 {
-    auto prefs = Preferences::get();
-    tolerance = prefs->getIntLimited("/options/dragtolerance/value", 0, 0, 100);
-    double const zoom_inc = prefs->getDoubleLimited("/options/zoomincrement/value", M_SQRT2, 1.01, 10);
+    tolerance = _drag_tolerance;
+    double const zoom_inc = _zoom_increment;
 
     bool ret = false;
 
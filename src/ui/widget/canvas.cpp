@@ -34,6 +34,7 @@
 #include <gtkmm/applicationwindow.h>
 #include <gtkmm/gestureclick.h>
 #include <sigc++/functors/mem_fun.h>
+#include <sigc++/scoped_connection.h>
 
 #include "canvas/fragment.h"
 #include "canvas/graphics.h"
@@ -119,6 +120,11 @@ auto pref_to_updater(int index)
     return arr[index - 1];
 }
 
+FrameCheck::Counter tiles_painted("canvas-tiles-painted"); // For profiling.
+
+// How long after the last zoom or pan to keep rendering in draft quality, in microseconds.
+constexpr gint64 DRAFT_MOTION_TIMEOUT = 200000;
+
 std::optional<Antialiasing> get_antialiasing_override(bool enabled)
 {
     if (enabled) {
@@ -136,6 +142,7 @@ struct Tile
     Fragment fragment;
     Cairo::RefPtr<Cairo::ImageSurface> surface;
     Cairo::RefPtr<Cairo::ImageSurface> outline_surface;
+    bool draft;
 };
 
 // The urgency with which the async redraw process should exit.
@@ -156,6 +163,7 @@ struct RedrawData
     bool decoupled_mode;
     Cairo::RefPtr<Cairo::Region> snapshot_drawn;
     std::shared_ptr<Colors::CMS::Transform> cms_transform;
+    bool draft;
 
     // Saved prefs
     int coarsener_min_size;
@@ -229,11 +237,17 @@ public:
     // Stores
     Stores stores;
     void handle_stores_action(Stores::Action action);
+    Cairo::RefPtr<Cairo::Region> clean_store_region() const;
 
     // Invalidation
     std::unique_ptr<Updater> updater; // Tracks the unclean region and decides how to redraw it.
     Cairo::RefPtr<Cairo::Region> invalidated; // Buffers invalidations while the updater is in use by the background process.
 
+    // Progressive rendering
+    gint64 last_motion = 0; // Time of the last zoom or pan.
+    Cairo::RefPtr<Cairo::Region> draft_region; // Region of the store drawn in draft quality, awaiting refinement.
+    sigc::scoped_connection refine_conn;
+
     // Graphics state; holds all the graphics resources, including the drawn content.
     std::unique_ptr<Graphics> graphics;
     void activate_graphics();
@@ -356,12 +370,14 @@ Canvas::Canvas()
     d->updater = Updater::create(pref_to_updater(d->prefs.update_strategy));
     d->updater->reset();
     d->invalidated = Cairo::Region::create();
+    d->draft_region = Cairo::Region::create();
 
     // Preferences
     d->prefs.grabsize.action = [this] { d->canvasitem_ctx->root()->update_canvas_item_ctrl_sizes(d->prefs.grabsize); };
     d->prefs.debug_show_unclean.action = [this] { queue_draw(); };
     d->prefs.debug_show_clean.action = [this] { queue_draw(); };
     d->prefs.debug_disable_redraw.action = [this] { d->schedule_redraw(); };
+    d->prefs.progressive_render.action = [this] { d->schedule_redraw(); };
     d->prefs.debug_sticky_decoupled.action = [this] { d->schedule_redraw(); };
     d->prefs.debug_animate.action = [this] { queue_draw(); };
     d->prefs.outline_overlay_opacity.action = [this] { queue_draw(); };
@@ -645,7 +661,7 @@ void CanvasPrivate::launch_redraw()
     q->_drawing->setClip(calc_page_clip());
 
     // Stores.
-    handle_stores_action(stores.update(Fragment{ q->_affine, q->get_area_world() }));
+    handle_stores_action(stores.update(Fragment{ q->_affine, q->get_area_world() }, clean_store_region()));
 
     // Geometry.
     bool const affine_changed = canvasitem_ctx->affine() != stores.store().affine;
@@ -668,6 +684,15 @@ void CanvasPrivate::launch_redraw()
     updater->mark_dirty(invalidated);
     invalidated = Cairo::Region::create();
 
+    // Progressive rendering: draw in draft quality while the view is moving, then hand the
+    // draft content back to the updater as dirty so it gets refined once motion stops.
+    refine_conn.disconnect();
+    rd.draft = prefs.progressive_render && g_get_monotonic_time() - last_motion < DRAFT_MOTION_TIMEOUT;
+    if (!rd.draft && !draft_region->empty()) {
+        updater->mark_dirty(draft_region);
+        draft_region = Cairo::Region::create();
+    }
+
     updater->next_frame();
 
     /*
@@ -717,6 +742,7 @@ void CanvasPrivate::launch_redraw()
     rd.page = page;
     rd.desk = desk;
     rd.debug_framecheck = prefs.debug_framecheck;
+    FrameCheck::set_enabled(prefs.debug_framecheck);
     rd.debug_show_redraw = prefs.debug_show_redraw;
 
     rd.snapshot_drawn = stores.snapshot().drawn ? stores.snapshot().drawn->copy() : Cairo::RefPtr<Cairo::Region>();
@@ -746,7 +772,7 @@ void CanvasPrivate::after_redraw()
     // Handle any pending stores action.
     bool stores_changed = false;
     if (!rd.timeoutflag) {
-        auto const ret = stores.finished_draw(Fragment{ q->_affine, q->get_area_world() });
+        auto const ret = stores.finished_draw(Fragment{ q->_affine, q->get_area_world() }, clean_store_region());
         handle_stores_action(ret);
         if (ret != Stores::Action::None) {
             stores_changed = true;
@@ -761,15 +787,30 @@ void CanvasPrivate::after_redraw()
     } else {
         if (prefs.debug_logging) std::cout << "Redraw exit" << std::endl;
         redraw_active = false;
+
+        // Come back to refine draft content once the view has stopped moving.
+        if (!draft_region->empty()) {
+            refine_conn = Glib::signal_timeout().connect([this] { schedule_redraw(); return false; }, DRAFT_MOTION_TIMEOUT / 1000);
+        }
     }
 }
 
+// Return the region of the store whose content is up-to-date, taking into account pending invalidations.
+Cairo::RefPtr<Cairo::Region> CanvasPrivate::clean_store_region() const
+{
+    auto clean = updater->clean_region->copy();
+    clean->subtract(invalidated);
+    clean->subtract(draft_region);
+    return clean;
+}
+
 void CanvasPrivate::handle_stores_action(Stores::Action action)
 {
     switch (action) {
         case Stores::Action::Recreated:
             // Set everything as needing redraw.
             invalidated->do_union(geom_to_cairo(stores.store().rect));
+            draft_region = Cairo::Region::create();
             updater->reset();
 
             if (prefs.debug_show_unclean) q->queue_draw();
@@ -777,11 +818,25 @@ void CanvasPrivate::handle_stores_action(Stores::Action action)
 
         case Stores::Action::Shifted:
             invalidated->intersect(geom_to_cairo(stores.store().rect));
+            draft_region->intersect(geom_to_cairo(stores.store().rect));
             updater->intersect(stores.store().rect);
 
             if (prefs.debug_show_unclean) q->queue_draw();
             break;
 
+        case Stores::Action::Restored:
+            // Set everything except the content restored from the tile pyramid as needing redraw.
+            invalidated = Cairo::Region::create(geom_to_cairo(stores.store().rect));
+            invalidated->subtract(stores.store().drawn);
+            draft_region = Cairo::Region::create();
+            updater->reset();
+            for (int i = 0; i < stores.store().drawn->get_num_rectangles(); i++) {
+                updater->mark_clean(cairo_to_geom(stores.store().drawn->get_rectangle(i)));
+            }
+
+            q->queue_draw();
+            break;
+
         default:
             break;
     }
@@ -811,6 +866,13 @@ void CanvasPrivate::commit_tiles()
         assert(stores.store().rect.contains(tile.fragment.rect));
         stores.mark_drawn(tile.fragment.rect);
 
+        // Track draft content needing refinement.
+        if (tile.draft) {
+            draft_region->do_union(geom_to_cairo(tile.fragment.rect));
+        } else {
+            draft_region->subtract(geom_to_cairo(tile.fragment.rect));
+        }
+
         // Get the rectangle of screen-space needing repaint.
         Geom::IntRect repaint_rect;
         if (stores.mode() == Stores::Mode::Normal) {
@@ -1615,6 +1677,7 @@ void Canvas::redraw_all()
         return;
     }
     d->invalidated->do_union(geom_to_cairo(d->stores.store().rect));
+    d->stores.clear_levels();
     d->schedule_redraw();
     if (d->prefs.debug_show_unclean) queue_draw();
 }
@@ -1651,6 +1714,7 @@ void Canvas::redraw_area(int x0, int y0, int x1, int y1)
 
     auto const rect = Geom::IntRect(x0, y0, x1, y1);
     d->invalidated->do_union(geom_to_cairo(rect));
+    d->stores.invalidate_levels(rect);
     d->schedule_redraw();
     if (d->prefs.debug_show_unclean) queue_draw();
 }
@@ -1697,6 +1761,7 @@ void Canvas::set_pos(Geom::IntPoint const &pos)
     }
 
     _pos = pos;
+    d->last_motion = g_get_monotonic_time();
 
     d->schedule_redraw();
     queue_draw();
@@ -1712,6 +1777,7 @@ void Canvas::set_affine(Geom::Affine const &affine)
     }
 
     _affine = affine;
+    d->last_motion = g_get_monotonic_time();
 
     d->schedule_redraw();
     queue_draw();
@@ -2234,11 +2300,9 @@ void CanvasPrivate::render_tile(int debug_id)
 {
     rd.mutex.lock();
 
-    std::string fc_str;
     FrameCheck::Event fc;
     if (rd.debug_framecheck) {
-        fc_str = "render_thread_" + std::to_string(debug_id + 1);
-        fc = FrameCheck::Event(fc_str.c_str());
+        fc = FrameCheck::Event(FrameCheck::intern("render_thread_" + std::to_string(debug_id + 1)));
     }
 
     while (true) {
@@ -2368,6 +2432,12 @@ void CanvasPrivate::paint_rect(Geom::IntRect const &rect)
     // Make sure the paint rectangle lies within the store.
     assert(rd.store.rect.contains(rect));
 
+    FrameCheck::Event fc;
+    if (rd.debug_framecheck) {
+        fc = FrameCheck::Event("paint_rect", rd.draft);
+    }
+    tiles_painted.add();
+
     auto paint = [&, this] (bool need_background, bool outline_pass) {
 
         auto surface = graphics->request_tile_surface(rect, true);
@@ -2402,6 +2472,7 @@ void CanvasPrivate::paint_rect(Geom::IntRect const &rect)
     Tile tile;
     tile.fragment.affine = rd.store.affine;
     tile.fragment.rect = rect;
+    tile.draft = rd.draft;
     tile.surface = paint(rd.background_in_stores_required, false);
     if (outlines_enabled) {
         tile.outline_surface = paint(false, true);
@@ -2433,8 +2504,17 @@ void CanvasPrivate::paint_single_buffer(Cairo::RefPtr<Cairo::ImageSurface> const
     cr->restore();
 
     // Render drawing on top of background.
-    auto buf = CanvasItemBuffer{ rect, scale_factor, cr, outline_pass };
-    canvasitem_ctx->root()->render(buf);
+    if (rd.draft && scale_factor > 1) {
+        // Draft on a high-dpi display: render at device scale 1 and upscale onto the tile.
+        auto lowres = Cairo::ImageSurface::create(Cairo::ImageSurface::Format::ARGB32, rect.width(), rect.height());
+        auto buf = CanvasItemBuffer{ rect, 1, Cairo::Context::create(lowres), outline_pass, true };
+        canvasitem_ctx->root()->render(buf);
+        cr->set_source(lowres, 0, 0);
+        cr->paint();
+    } else {
+        auto buf = CanvasItemBuffer{ rect, scale_factor, cr, outline_pass, rd.draft };
+        canvasitem_ctx->root()->render(buf);
+    }
 
     // Apply CMS transform for the screen. This rarely is used by modern desktops, but sometimes
     // the user will apply an RGB transform to color correct their screen. This happens now, so the
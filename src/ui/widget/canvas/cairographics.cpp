@@ -25,6 +25,9 @@ void CairoGraphics::set_outlines_enabled(bool enabled)
     if (!enabled) {
         store.outline_surface.reset();
         snapshot.outline_surface.reset();
+        for (auto &[id, level] : levels) {
+            level.outline_surface.reset();
+        }
     }
 }
 
@@ -209,6 +212,57 @@ void CairoGraphics::snapshot_combine(Fragment const &dest)
     snapshot = std::move(fragment);
 }
 
+CairoFragment CairoGraphics::paste_fragment(CairoFragment const &from, Fragment const &src, Fragment const &dest) const
+{
+    auto surface_size = dest.rect.dimensions() * scale_factor;
+
+    auto make_surface = [&, this] {
+        auto surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, surface_size.x(), surface_size.y());
+        cairo_surface_set_device_scale(surface->cobj(), scale_factor, scale_factor); // No C++ API!
+        return surface;
+    };
+
+    // Both fragments are at the same affine, so this is a simple shifted copy.
+    auto shift = src.rect.min() - dest.rect.min();
+
+    auto copy = [&, this] (Cairo::RefPtr<Cairo::ImageSurface> const &from_surface, bool background) {
+        auto to = make_surface();
+        auto cr = Cairo::Context::create(to);
+        if (background) paint_background(dest, pi, page, desk, cr);
+        cr->rectangle(shift.x(), shift.y(), src.rect.width(), src.rect.height());
+        cr->clip();
+        cr->set_source(from_surface, shift.x(), shift.y());
+        cr->set_operator(Cairo::Context::Operator::SOURCE);
+        cr->paint();
+        return to;
+    };
+
+    CairoFragment result;
+                          result.surface         = copy(from.surface,         background_in_stores);
+    if (outlines_enabled) result.outline_surface = copy(from.outline_surface, false);
+    return result;
+}
+
+std::size_t CairoGraphics::stash_level(int id)
+{
+    auto const &level = levels[id] = paste_fragment(store, stores.store(), stores.store());
+    auto const size = dimensions(level.surface);
+    return static_cast<std::size_t>(size.x()) * size.y() * 4 * (outlines_enabled ? 2 : 1);
+}
+
+void CairoGraphics::restore_level(int id, Fragment const &src, Fragment const &dest)
+{
+    auto it = levels.find(id);
+    store = paste_fragment(it->second, src, dest);
+    levels.erase(it);
+}
+
+void CairoGraphics::snapshot_level(int id, Fragment const &src)
+{
+    // Copy, since the snapshot is drawn over and its surfaces recycled.
+    snapshot = paste_fragment(levels.at(id), src, src);
+}
+
 Cairo::RefPtr<Cairo::ImageSurface> CairoGraphics::request_tile_surface(Geom::IntRect const &rect, bool /*nogl*/)
 {
     // Create temporary surface, isolated from store.
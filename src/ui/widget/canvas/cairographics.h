@@ -8,6 +8,8 @@
 #ifndef INKSCAPE_UI_WIDGET_CANVAS_CAIROGRAPHICS_H
 #define INKSCAPE_UI_WIDGET_CANVAS_CAIROGRAPHICS_H
 
+#include <unordered_map>
+
 #include "graphics.h"
 
 namespace Inkscape::UI::Widget {
@@ -35,6 +37,11 @@ public:
     void snapshot_combine(Fragment const &dest) override;
     void invalidate_snapshot() override {}
 
+    std::size_t stash_level(int id) override;
+    void restore_level(int id, Fragment const &src, Fragment const &dest) override;
+    void snapshot_level(int id, Fragment const &src) override;
+    void drop_level(int id) override { levels.erase(id); }
+
     bool is_opengl() const override { return false; }
     void invalidated_glstate() override {}
 
@@ -47,6 +54,9 @@ public:
 private:
     // Drawn content.
     CairoFragment store, snapshot;
+    std::unordered_map<int, CairoFragment> levels;
+
+    CairoFragment paste_fragment(CairoFragment const &from, Fragment const &src, Fragment const &dest) const;
 
     // Dependency objects in canvas.
     Prefs const &prefs;
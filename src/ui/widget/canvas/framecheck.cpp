@@ -1,26 +1,182 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
-#include <fstream>
-#include <iostream>
+#include <algorithm>
+#include <array>
+#include <locale>
+#include <memory>
 #include <mutex>
-#include <boost/filesystem.hpp> // Using boost::filesystem instead of std::filesystem due to broken C++17 on MacOS.
+#include <ostream>
+#include <unordered_set>
 #include "framecheck.h"
-namespace fs = boost::filesystem;
 
 namespace Inkscape::FrameCheck {
+namespace {
 
-void Event::write()
+struct Record
+{
+    char const *name;
+    gint64 start;
+    gint64 end;
+    int subtype;
+};
+
+// The events recorded by a single thread. Kept alive by the registry after the thread exits.
+struct ThreadLog
+{
+    static constexpr std::size_t capacity = 1 << 14;
+
+    std::mutex mutex; // Only contended while exporting.
+    std::array<Record, capacity> records;
+    std::size_t count = 0; // Total number of records ever written; the ring holds the last capacity of them.
+    int tid;
+};
+
+struct Registry
 {
-    static std::mutex mutex;
-    static auto logfile = [] {
-        auto path = fs::temp_directory_path() / "framecheck.txt";
-        auto mode = std::ios_base::out | std::ios_base::app | std::ios_base::binary;
-        auto f = std::ofstream(path.string(), mode);
-        f.imbue(std::locale::classic());
-        return f;
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadLog>> logs;
+    std::vector<Counter *> counters;
+    std::unordered_set<std::string> names;
+};
+
+Registry &registry()
+{
+    static Registry r;
+    return r;
+}
+
+ThreadLog &thread_log()
+{
+    thread_local auto const log = [] {
+        auto log = std::make_shared<ThreadLog>();
+        auto &r = registry();
+        auto lock = std::lock_guard(r.mutex);
+        log->tid = r.logs.size() + 1;
+        r.logs.push_back(log);
+        return log;
     }();
+    return *log;
+}
+
+void write_json_string(std::ostream &os, char const *str)
+{
+    os << '"';
+    for (auto c = str; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            os << '\\';
+        }
+        if (static_cast<unsigned char>(*c) >= 0x20) {
+            os << *c;
+        }
+    }
+    os << '"';
+}
+
+} // namespace
+
+char const *intern(std::string const &name)
+{
+    auto &r = registry();
+    auto lock = std::lock_guard(r.mutex);
+    return r.names.insert(name).first->c_str();
+}
+
+void Event::write()
+{
+    auto &log = thread_log();
+    auto lock = std::lock_guard(log.mutex);
+    log.records[log.count % ThreadLog::capacity] = { name, start, g_get_monotonic_time(), subtype };
+    log.count++;
+}
+
+Counter::Counter(char const *name)
+    : _name(name)
+{
+    auto &r = registry();
+    auto lock = std::lock_guard(r.mutex);
+    r.counters.push_back(this);
+}
+
+Counter::~Counter()
+{
+    auto &r = registry();
+    auto lock = std::lock_guard(r.mutex);
+    std::erase(r.counters, this);
+}
+
+std::vector<std::pair<std::string, std::int64_t>> get_counters()
+{
+    std::vector<std::pair<std::string, std::int64_t>> result;
+
+    {
+        auto &r = registry();
+        auto lock = std::lock_guard(r.mutex);
+        for (auto counter : r.counters) {
+            result.emplace_back(counter->name(), counter->value());
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void reset()
+{
+    auto &r = registry();
+    auto lock = std::lock_guard(r.mutex);
+
+    for (auto counter : r.counters) {
+        counter->reset();
+    }
+
+    for (auto &log : r.logs) {
+        auto lock2 = std::lock_guard(log->mutex);
+        log->count = 0;
+    }
+}
+
+void write_chrome_trace(std::ostream &os)
+{
+    auto &r = registry();
+    auto lock = std::lock_guard(r.mutex);
+
+    auto const loc = os.getloc();
+    os.imbue(std::locale::classic());
+
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    auto sep = [&] {
+        os << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    for (auto const &log : r.logs) {
+        auto lock2 = std::lock_guard(log->mutex);
+        auto const begin = log->count > ThreadLog::capacity ? log->count - ThreadLog::capacity : 0;
+        for (auto i = begin; i < log->count; i++) {
+            auto const &rec = log->records[i % ThreadLog::capacity];
+            sep();
+            os << "{\"name\":";
+            write_json_string(os, rec.name);
+            os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << log->tid
+               << ",\"ts\":" << rec.start
+               << ",\"dur\":" << rec.end - rec.start
+               << ",\"args\":{\"subtype\":" << rec.subtype << "}}";
+        }
+    }
+
+    // Emit the counters as a single sample at the current time.
+    sep();
+    os << "{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"ts\":" << g_get_monotonic_time() << ",\"args\":{";
+    for (auto counter : r.counters) {
+        if (counter != r.counters.front()) {
+            os << ',';
+        }
+        write_json_string(os, counter->name());
+        os << ':' << counter->value();
+    }
+    os << "}}\n]}\n";
 
-    auto lock = std::lock_guard(mutex);
-    logfile << name << ' ' << start << ' ' << g_get_monotonic_time() << ' ' << subtype << std::endl;
+    os.imbue(loc);
 }
 
 } // namespace Inkscape::FrameCheck
@@ -2,11 +2,32 @@
 #ifndef INKSCAPE_FRAMECHECK_H
 #define INKSCAPE_FRAMECHECK_H
 
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
 #include <glib.h>
 
 namespace Inkscape::FrameCheck {
 
-/// RAII object that logs a timing event for the duration of its lifetime.
+inline std::atomic<bool> enabled_flag = false;
+
+/// Whether code outside the canvas should record events and counters.
+inline bool is_enabled() { return enabled_flag.load(std::memory_order_relaxed); }
+inline void set_enabled(bool enabled) { enabled_flag.store(enabled, std::memory_order_relaxed); }
+
+/// Return a copy of a string that lives forever, for use as a dynamically-generated event name.
+char const *intern(std::string const &name);
+
+/**
+ * RAII object that logs a timing event for the duration of its lifetime.
+ *
+ * Events are recorded into a fixed-size ring buffer belonging to the calling thread, so only
+ * the most recent events are kept. The name must outlive the recording; use a string literal
+ * or intern().
+ */
 struct Event
 {
     gint64 start;
@@ -42,6 +63,41 @@ private:
     void write();
 };
 
+/// A named process-wide tally, such as of cache hits. Only counts while recording is enabled.
+class Counter
+{
+public:
+    explicit Counter(char const *name);
+    ~Counter();
+    Counter(Counter const &) = delete;
+    Counter &operator=(Counter const &) = delete;
+
+    void add(std::int64_t n = 1)
+    {
+        if (is_enabled()) {
+            _value.fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+
+    char const *name() const { return _name; }
+    std::int64_t value() const { return _value.load(std::memory_order_relaxed); }
+    void reset() { _value.store(0, std::memory_order_relaxed); }
+
+private:
+    char const *_name;
+    std::atomic<std::int64_t> _value = 0;
+};
+
+/// Return the current value of every counter, sorted by name.
+std::vector<std::pair<std::string, std::int64_t>> get_counters();
+
+/// Zero all counters and discard all recorded events.
+void reset();
+
+/// Write all recorded events and the counters in Chrome's trace event format,
+/// suitable for loading into chrome://tracing or Perfetto.
+void write_chrome_trace(std::ostream &os);
+
 } // namespace Inkscape::FrameCheck
 
 #endif // INKSCAPE_FRAMECHECK_H
@@ -372,6 +372,9 @@ void GLGraphics::set_outlines_enabled(bool enabled)
     if (!enabled) {
         store.outline_texture.clear();
         snapshot.outline_texture.clear();
+        for (auto &[id, level] : levels) {
+            level.outline_texture.clear();
+        }
     }
 }
 
@@ -572,6 +575,66 @@ void GLGraphics::invalidate_snapshot()
     if (snapshot.outline_texture) snapshot.outline_texture.invalidate();
 }
 
+GLFragment GLGraphics::paste_fragment(GLFragment const &from, Fragment const &src, Fragment const &dest)
+{
+    auto tex_size = dest.rect.dimensions() * scale_factor;
+
+    // Setup the base pipeline.
+    setup_stores_pipeline();
+
+    // Create the new fragment.
+    GLFragment fragment;
+    fragment.texture = Texture(tex_size);
+    if (outlines_enabled) {
+        fragment.outline_texture = Texture(tex_size);
+    }
+
+    // Bind the new fragment to the framebuffer for writing to.
+                          glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, fragment.texture        .id(), 0);
+    if (outlines_enabled) glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, fragment.outline_texture.id(), 0);
+    glViewport(0, 0, fragment.texture.size().x(), fragment.texture.size().y());
+
+    // Clear it to transparent.
+    glClearColor(0.0, 0.0, 0.0, 0.0);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // Bind the source to texture units 0 and 1 for reading from.
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, from.texture.id());
+    glUniform1i(tex_loc, 0);
+    if (outlines_enabled) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, from.outline_texture.id());
+        glUniform1i(texoutline_loc, 1);
+    }
+    glBindVertexArray(rect.vao);
+
+    // Copy the source into the new fragment.
+    geom_to_uniform(calc_paste_transform(src, dest), mat_loc, trans_loc);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+    return fragment;
+}
+
+std::size_t GLGraphics::stash_level(int id)
+{
+    auto const &level = levels[id] = paste_fragment(store, stores.store(), stores.store());
+    auto const size = level.texture.size();
+    return static_cast<std::size_t>(size.x()) * size.y() * 4 * (outlines_enabled ? 2 : 1);
+}
+
+void GLGraphics::restore_level(int id, Fragment const &src, Fragment const &dest)
+{
+    auto it = levels.find(id);
+    store = paste_fragment(it->second, src, dest);
+    levels.erase(it);
+}
+
+void GLGraphics::snapshot_level(int id, Fragment const &src)
+{
+    snapshot = paste_fragment(levels.at(id), src, src);
+}
+
 void GLGraphics::setup_tiles_pipeline()
 {
     if (state == State::Tiles) return;
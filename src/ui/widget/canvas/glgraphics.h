@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <boost/noncopyable.hpp>
 #include <epoxy/gl.h>
 
@@ -83,6 +84,11 @@ public:
     void snapshot_combine(Fragment const &dest) override;
     void invalidate_snapshot() override;
 
+    std::size_t stash_level(int id) override;
+    void restore_level(int id, Fragment const &src, Fragment const &dest) override;
+    void snapshot_level(int id, Fragment const &src) override;
+    void drop_level(int id) override { levels.erase(id); }
+
     bool is_opengl() const override { return true; }
     void invalidated_glstate() override { state = State::None; }
 
@@ -95,6 +101,9 @@ public:
 private:
     // Drawn content.
     GLFragment store, snapshot;
+    std::unordered_map<int, GLFragment> levels;
+
+    GLFragment paste_fragment(GLFragment const &from, Fragment const &src, Fragment const &dest);
 
     // OpenGL objects.
     VAO rect; // Rectangle vertex data.
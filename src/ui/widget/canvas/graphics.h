@@ -8,6 +8,7 @@
 #ifndef INKSCAPE_UI_WIDGET_CANVAS_GRAPHICS_H
 #define INKSCAPE_UI_WIDGET_CANVAS_GRAPHICS_H
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -58,6 +59,12 @@ public:
     virtual void snapshot_combine(Fragment const &dest) = 0; ///< Paste the snapshot followed by the store onto a new snapshot at \a dest.
     virtual void invalidate_snapshot() = 0; ///< Indicate that the content in the snapshot store is not going to be used again.
 
+    // Tile pyramid manipulation.
+    virtual std::size_t stash_level(int id) = 0; ///< Copy the store into a new pyramid level \a id, returning the memory it uses.
+    virtual void restore_level(int id, Fragment const &src, Fragment const &dest) = 0; ///< Set the store to level \a id (at \a src) pasted into \a dest, and free the level.
+    virtual void snapshot_level(int id, Fragment const &src) = 0; ///< Set the snapshot to a copy of level \a id (at \a src).
+    virtual void drop_level(int id) = 0; ///< Free the content of level \a id.
+
     // Misc.
     virtual bool is_opengl() const = 0; ///< Whether this is an OpenGL backend.
     virtual void invalidated_glstate() = 0; ///< Tells the Graphics to no longer rely on any OpenGL state it had set up.
@@ -20,6 +20,7 @@ public:
     Pref<int>    outline_overlay_opacity  = { "/options/rendering/outline-overlay-opacity", 50, 0, 100 };
     Pref<int>    update_strategy          = { "/options/rendering/update_strategy", 3, 1, 3 };
     Pref<bool>   request_opengl           = { "/options/rendering/request_opengl" };
+    Pref<bool>   progressive_render       = { "/options/rendering/progressive_render" };
     Pref<int>    grabsize                 = { "/options/grabsize/value", 3, 1, 15 };
     Pref<int>    numthreads               = { "/options/threading/numthreads", 0, 1, 256 };
 
@@ -42,6 +43,7 @@ public:
     Pref<int>    coarsener_min_size       = { "/options/rendering/coarsener_min_size", 200, 0, 1000 };
     Pref<int>    coarsener_glue_size      = { "/options/rendering/coarsener_glue_size", 80, 0, 1000 };
     Pref<double> coarsener_min_fullness   = { "/options/rendering/coarsener_min_fullness", 0.3, 0.0, 1.0 };
+    Pref<int>    tile_pyramid_size        = { "/options/rendering/tile_pyramid_size", 64, 0, 4096 };
 
     // Debug switches
     Pref<bool>   debug_framecheck         = { "/options/rendering/debug_framecheck" };
@@ -71,6 +73,7 @@ private:
         coarsener_min_size.set_enabled(on);
         coarsener_glue_size.set_enabled(on);
         coarsener_min_fullness.set_enabled(on);
+        tile_pyramid_size.set_enabled(on);
         debug_framecheck.set_enabled(on);
         debug_logging.set_enabled(on);
         debug_delay_redraw.set_enabled(on);
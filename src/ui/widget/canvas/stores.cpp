@@ -92,6 +92,28 @@ auto region_affine_approxinwards(Cairo::RefPtr<Cairo::Region> const &reg, Geom::
     return regdst;
 }
 
+// Determine whether two affines are equal up to rounding error, as happens when returning to a zoom level by inverse steps.
+bool approx_same_affine(Geom::Affine const &a, Geom::Affine const &b)
+{
+    for (int i = 0; i < 6; i++) {
+        if (std::abs(a[i] - b[i]) > 1e-6 * std::max({std::abs(a[i]), std::abs(b[i]), 1.0})) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Return the total area of a region.
+double region_area(Cairo::RefPtr<Cairo::Region> const &reg)
+{
+    double area = 0.0;
+    for (int i = 0; i < reg->get_num_rectangles(); i++) {
+        auto const rect = reg->get_rectangle(i);
+        area += static_cast<double>(rect.width) * rect.height;
+    }
+    return area;
+}
+
 } // namespace
 
 Geom::IntRect Stores::centered(Fragment const &view) const
@@ -122,19 +144,28 @@ void Stores::shift_store(Fragment const &view)
     _store.drawn->intersect(geom_to_cairo(_store.rect));
 };
 
-void Stores::take_snapshot(Fragment const &view)
+auto Stores::take_snapshot(Fragment const &view, Cairo::RefPtr<Cairo::Region> const &clean) -> Action
 {
+    // Keep the up-to-date content of the store in the tile pyramid, in case we come back to this affine.
+    stash_level(clean);
     // Copy the store to the snapshot, leaving us temporarily in an invalid state.
     _snapshot = std::move(_store);
     // Tell the graphics to do the same, except swapping them so we can re-use the old snapshot store.
     _graphics->swap_stores();
-    // Reset the store.
-    recreate_store(view);
+    // Reset the store, starting from the pyramid level at the view's affine if there is one.
+    auto action = Action::Restored;
+    if (!restore_level(view)) {
+        recreate_store(view);
+        action = Action::Recreated;
+    }
+    // Use a level of the pyramid as the snapshot instead if it makes a better placeholder.
+    pick_snapshot_level(view);
     // Transform the snapshot's drawn region to the new store's affine.
     _snapshot.drawn = shrink_region(region_affine_approxinwards(_snapshot.drawn, _snapshot.affine.inverse() * _store.affine, _store.rect), 4, -2);
+    return action;
 }
 
-void Stores::snapshot_combine(Fragment const &view)
+auto Stores::snapshot_combine(Fragment const &view) -> Action
 {
     // Add the drawn region to the snapshot drawn region (they both exist in store space, so this is valid), and save its affine.
     _snapshot.drawn->do_union(_store.drawn);
@@ -239,22 +270,153 @@ void Stores::snapshot_combine(Fragment const &view)
         _snapshot.affine = affine;
     }
 
-    // Start drawing again on a new blank store aligned to the screen.
-    recreate_store(view);
+    // Start drawing again on a new store aligned to the screen, blank unless the tile pyramid has a level at the view's affine.
+    auto action = Action::Restored;
+    if (!restore_level(view)) {
+        recreate_store(view);
+        action = Action::Recreated;
+    }
     // Transform the snapshot clean region to the new store.
     // Todo: Should really clip this to the new snapshot rect, only we can't because it's generally not aligned with the store's affine.
     _snapshot.drawn = shrink_region(region_affine_approxinwards(_snapshot.drawn, old_store_affine.inverse() * _store.affine, _store.rect), 4, -2);
+    return action;
 };
 
+void Stores::stash_level(Cairo::RefPtr<Cairo::Region> const &clean)
+{
+    auto const budget = static_cast<std::size_t>(_prefs.tile_pyramid_size) << 20;
+    if (budget == 0) {
+        clear_levels();
+        return;
+    }
+
+    // Only the up-to-date drawn content is worth keeping.
+    auto drawn = _store.drawn->copy();
+    drawn->intersect(clean);
+    if (drawn->empty()) return;
+
+    // A newer level replaces any older one at the same affine.
+    if (auto it = std::find_if(_levels.begin(), _levels.end(), [&] (Level const &level) { return approx_same_affine(level.affine, _store.affine); });
+        it != _levels.end())
+    {
+        drop_level(it);
+    }
+
+    Level level;
+    level.affine = _store.affine;
+    level.rect = _store.rect;
+    level.drawn = std::move(drawn);
+    level.id = _next_level_id++;
+    level.bytes = _graphics->stash_level(level.id);
+    _levels.push_back(std::move(level));
+
+    // Evict the least recently used levels until within the memory budget.
+    std::size_t total = 0;
+    for (auto const &l : _levels) {
+        total += l.bytes;
+    }
+    while (total > budget) {
+        total -= _levels.front().bytes;
+        drop_level(_levels.begin());
+    }
+
+    if (_prefs.debug_logging) std::cout << "Stashed pyramid level, " << _levels.size() << " levels using " << (total >> 20) << " MiB" << std::endl;
+}
+
+bool Stores::restore_level(Fragment const &view)
+{
+    auto it = std::find_if(_levels.begin(), _levels.end(), [&] (Level const &level) { return approx_same_affine(level.affine, view.affine); });
+    if (it == _levels.end()) return false;
+
+    // Check that some of its content lands in the new store; otherwise it is of no use.
+    auto rect = centered(view);
+    auto drawn = it->drawn->copy();
+    drawn->intersect(geom_to_cairo(rect));
+    if (drawn->empty()) {
+        drop_level(it);
+        return false;
+    }
+
+    // Tell the graphics to recreate the store from the level. The level is consumed, and stashed again when the store is left.
+    _graphics->restore_level(it->id, *it, Fragment{ view.affine, rect });
+    _store.affine = view.affine;
+    _store.rect = rect;
+    _store.drawn = std::move(drawn);
+    _levels.erase(it);
+
+    if (_prefs.debug_logging) std::cout << "Restored pyramid level" << std::endl;
+    return true;
+}
+
+void Stores::pick_snapshot_level(Fragment const &view)
+{
+    // Score a store as a placeholder by the fraction of the view it covers, weighted by how much detail it lacks.
+    auto score = [&] (Store const &s) {
+        auto covered = region_affine_approxinwards(s.drawn, s.affine.inverse() * view.affine, view.rect);
+        covered->intersect(geom_to_cairo(view.rect));
+        double coverage = region_area(covered) / static_cast<double>(view.rect.area());
+        double detail = std::min(1.0, std::sqrt(std::abs(s.affine.det() / view.affine.det())));
+        return coverage * detail;
+    };
+
+    // Require a clear improvement over the current snapshot to be worth the copy.
+    auto best = _levels.end();
+    double best_score = score(_snapshot) * 1.1;
+    for (auto it = _levels.begin(); it != _levels.end(); ++it) {
+        if (double s = score(*it); s > best_score) {
+            best = it;
+            best_score = s;
+        }
+    }
+    if (best == _levels.end()) return;
+
+    // Tell the graphics to copy the level into the snapshot.
+    _graphics->snapshot_level(best->id, *best);
+    _snapshot.affine = best->affine;
+    _snapshot.rect = best->rect;
+    _snapshot.drawn = best->drawn->copy();
+
+    // Mark the level as the most recently used.
+    std::rotate(best, best + 1, _levels.end());
+
+    if (_prefs.debug_logging) std::cout << "Snapshot from pyramid level" << std::endl;
+}
+
+void Stores::drop_level(std::vector<Level>::iterator it)
+{
+    _graphics->drop_level(it->id);
+    _levels.erase(it);
+}
+
+void Stores::invalidate_levels(Geom::IntRect const &rect)
+{
+    for (auto &level : _levels) {
+        // Transform from store space to the level's space, rounding outwards to cover any resampled pixels.
+        auto const r = (Geom::Parallelogram(rect) * _store.affine.inverse() * level.affine).bounds().roundOutwards();
+        level.drawn->subtract(geom_to_cairo(expandedBy(r, 1)));
+    }
+}
+
+void Stores::clear_levels()
+{
+    if (_graphics) {
+        for (auto const &level : _levels) {
+            _graphics->drop_level(level.id);
+        }
+    }
+    _levels.clear();
+}
+
 void Stores::reset()
 {
+    clear_levels();
     _mode = Mode::None;
     _store.drawn.reset();
     _snapshot.drawn.reset();
 }
 
 // Handle transitions and actions in response to viewport changes.
-auto Stores::update(Fragment const &view) -> Action
+auto Stores::update(Fragment const &view, Cairo::RefPtr<Cairo::Region> const &clean) -> Action
 {
     switch (_mode) {
         
@@ -271,11 +433,10 @@ auto Stores::update(Fragment const &view) -> Action
             // Enter decoupled mode if the affine has changed from what the store was drawn at.
             if (view.affine != _store.affine) {
                 // Snapshot and reset the store.
-                take_snapshot(view);
+                result = take_snapshot(view, clean);
                 // Enter decoupled mode.
                 _mode = Mode::Decoupled;
                 if (_prefs.debug_logging) std::cout << "Enter decoupled mode" << std::endl;
-                result = Action::Recreated;
             } else {
                 // Determine whether the view has moved sufficiently far that we need to shift the store.
                 if (!_store.rect.contains(expandedBy(view.rect, _prefs.prerender))) {
@@ -329,8 +490,7 @@ auto Stores::update(Fragment const &view) -> Action
 
             if (check_restart_redraw()) {
                 // Re-use as much content as possible from the store and the snapshot, and set as the new snapshot.
-                snapshot_combine(view);
-                return Action::Recreated;
+                return snapshot_combine(view);
             }
 
             return Action::None;
@@ -343,7 +503,7 @@ auto Stores::update(Fragment const &view) -> Action
     }
 }
 
-auto Stores::finished_draw(Fragment const &view) -> Action
+auto Stores::finished_draw(Fragment const &view, Cairo::RefPtr<Cairo::Region> const &clean) -> Action
 {
     // Finished drawing. Handle transitions out of decoupled mode, by checking if we need to reset the store to the correct affine.
     if (_mode == Mode::Decoupled) {
@@ -358,9 +518,9 @@ auto Stores::finished_draw(Fragment const &view) -> Action
         } else {
             // Content is rendered at the wrong affine - take a new snapshot and continue idle process to continue rendering at the new affine.
             // Snapshot and reset the backing store.
-            take_snapshot(view);
+            auto const action = take_snapshot(view, clean);
             if (_prefs.debug_logging) std::cout << "Remain in decoupled mode" << std::endl;
-            return Action::Recreated;
+            return action;
         }
     }
 
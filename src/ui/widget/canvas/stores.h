@@ -10,6 +10,9 @@
 #ifndef INKSCAPE_UI_WIDGET_CANVAS_STORES_H
 #define INKSCAPE_UI_WIDGET_CANVAS_STORES_H
 
+#include <cstddef>
+#include <vector>
+
 #include "fragment.h"
 #include "util.h"
 #include "ui/util.h"
@@ -34,7 +37,8 @@ public:
     {
         None,      /// The backing store was not changed.
         Recreated, /// The backing store was completely recreated.
-        Shifted    /// The backing store was shifted into a new rectangle.
+        Shifted,   /// The backing store was shifted into a new rectangle.
+        Restored   /// The backing store was recreated from a level of the tile pyramid, with its drawn region up-to-date.
     };
     
     struct Store : Fragment
@@ -52,31 +56,52 @@ public:
         , _graphics(nullptr)
         , _prefs(prefs) {}
 
-    /// Set the pointer to the graphics object.
-    void set_graphics(Graphics *g) { _graphics = g; }
+    /// Set the pointer to the graphics object. Forgets the tile pyramid, whose content lives in the old graphics.
+    void set_graphics(Graphics *g) { _graphics = g; _levels.clear(); }
 
     /// Discards all stores. (The actual operation on the graphics is performed on the next update().)
     void reset();
 
     /// Respond to a viewport change. (Requires a valid graphics.)
-    Action update(Fragment const &view);
+    /// The region of the store with up-to-date content is passed in \a clean, and is what may be kept in the tile pyramid.
+    Action update(Fragment const &view, Cairo::RefPtr<Cairo::Region> const &clean);
 
     /// Respond to drawing of the backing store having finished. (Requires a valid graphics.)
-    Action finished_draw(Fragment const &view);
+    Action finished_draw(Fragment const &view, Cairo::RefPtr<Cairo::Region> const &clean);
 
     /// Record a rectangle as being drawn to the store.
     void mark_drawn(Geom::IntRect const &rect) { _store.drawn->do_union(geom_to_cairo(rect)); }
 
+    /// Record a rectangle of the store as needing redraw in every level of the tile pyramid.
+    void invalidate_levels(Geom::IntRect const &rect);
+
+    /// Discard every level of the tile pyramid.
+    void clear_levels();
+
     // Getters.
     Store const &store() const { return _store; }
     Store const &snapshot() const { return _snapshot; }
     Mode mode() const { return _mode; }
 
 private:
+    /**
+     * A level of the tile pyramid: a former backing store kept after the view moved to a different affine,
+     * so that its content can be shown again when coming back to that affine.
+     */
+    struct Level : Store
+    {
+        int id;            ///< The key of its content in the graphics.
+        std::size_t bytes; ///< The memory used by its content.
+    };
+
     // Internal state.
     Mode _mode;
     Store _store, _snapshot;
 
+    // The tile pyramid, in order of least to most recently used.
+    std::vector<Level> _levels;
+    int _next_level_id = 0;
+
     // The graphics object that executes the operations on the stores.
     Graphics *_graphics;
 
@@ -87,8 +112,12 @@ private:
     Geom::IntRect centered(Fragment const &view) const;
     void recreate_store(Fragment const &view);
     void shift_store(Fragment const &view);
-    void take_snapshot(Fragment const &view);
-    void snapshot_combine(Fragment const &view);
+    Action take_snapshot(Fragment const &view, Cairo::RefPtr<Cairo::Region> const &clean);
+    Action snapshot_combine(Fragment const &view);
+    void stash_level(Cairo::RefPtr<Cairo::Region> const &clean);
+    bool restore_level(Fragment const &view);
+    void pick_snapshot_level(Fragment const &view);
+    void drop_level(std::vector<Level>::iterator it);
 };
 
 } // namespace Inkscape::UI::Widget
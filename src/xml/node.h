@@ -14,6 +14,7 @@
 #define SEEN_INKSCAPE_XML_NODE_H
 
 #include <vector>
+#include <boost/container/small_vector.hpp>
 
 #include <2geom/point.h>
 
@@ -31,7 +32,8 @@ class AttributeRecord;
 struct Document;
 class NodeObserver;
 
-using AttributeVector = std::vector<AttributeRecord, Inkscape::GC::Alloc<AttributeRecord>>;
+/// Attributes of a node. Most elements have only a few, which are stored inline without a separate allocation.
+using AttributeVector = boost::container::small_vector<AttributeRecord, 3, Inkscape::GC::Alloc<AttributeRecord>>;
 
 /**
  * @brief Enumeration containing all supported node types.
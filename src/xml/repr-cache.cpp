@@ -0,0 +1,546 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Binary cache of parsed XML documents.
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include "repr-cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <set>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glibmm/convert.h>
+#include <glibmm/miscutils.h>
+
+#include "preferences.h"
+#include "util/scope_exit.h"
+#include "xml/document.h"
+#include "xml/node.h"
+#include "xml/repr.h"
+#include "xml/simple-document.h"
+#include "xml/text-node.h"
+
+namespace Inkscape::XML {
+namespace {
+
+/*
+ * File layout, all integers in native byte order:
+ *
+ *   header   magic, version, byte order mark, parse time, file hash, parse settings
+ *   prefixes count, then (prefix, uri) for each namespace prefix used in the tree
+ *   strings  count, then for each: length, bytes, terminating nul
+ *   nodes    the children of the document node, each written in preorder as
+ *            type, flags, name, content, attribute count, (key, value) pairs, child count
+ *
+ * Strings are referred to by index into the string table; NO_STRING stands for null. As every
+ * string is nul-terminated, the loader can point straight into the mapped file.
+ */
+constexpr char MAGIC[8] = {'I', 'N', 'K', 'X', 'M', 'L', 'C', '\0'};
+constexpr std::uint32_t VERSION = 2;
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr std::uint32_t NO_STRING = 0xffffffff;
+constexpr std::uint8_t FLAG_CDATA = 1;
+
+constexpr gsize MIN_FILE_SIZE = 1 << 20; ///< Smaller files parse quickly enough that caching them is not worthwhile.
+constexpr int DEFAULT_CACHE_SIZE = 256;  ///< Default size limit of the cache directory, in MiB.
+
+// The file a DocumentCache::Scope allows to be cached, in the filename encoding.
+thread_local std::string scope_filename;
+
+std::string cache_dir()
+{
+    return Glib::build_filename(Glib::get_user_cache_dir(), "inkscape", "documents");
+}
+
+class Writer
+{
+public:
+    template <typename T>
+    void write(T const &value)
+    {
+        _buf.append(reinterpret_cast<char const *>(&value), sizeof(T));
+    }
+
+    void write_string(std::string_view str)
+    {
+        write<std::uint32_t>(str.size());
+        _buf.append(str);
+        _buf.push_back('\0');
+    }
+
+    std::string &buffer() { return _buf; }
+
+private:
+    std::string _buf;
+};
+
+class Reader
+{
+public:
+    Reader(char const *begin, char const *end) : _pos(begin), _end(end) {}
+
+    template <typename T>
+    bool read(T &value)
+    {
+        if (_end - _pos < static_cast<std::ptrdiff_t>(sizeof(T))) {
+            return false;
+        }
+        std::memcpy(&value, _pos, sizeof(T));
+        _pos += sizeof(T);
+        return true;
+    }
+
+    char const *read_string()
+    {
+        std::uint32_t len;
+        if (!read(len) || static_cast<std::size_t>(_end - _pos) <= len || _pos[len] != '\0') {
+            return nullptr;
+        }
+        auto const str = _pos;
+        _pos += len + 1;
+        return str;
+    }
+
+    bool at_end() const { return _pos == _end; }
+
+private:
+    char const *_pos;
+    char const *_end;
+};
+
+// Collects the strings of a tree into a table, and writes its nodes referring to them by index.
+class TreeWriter
+{
+public:
+    void collect(Node const &node)
+    {
+        add(node.name());
+        add(node.content());
+        add_prefix(node.name());
+        for (auto const &attr : node.attributeList()) {
+            add(g_quark_to_string(attr.key));
+            add(attr.value);
+            add_prefix(g_quark_to_string(attr.key));
+        }
+        for (auto child = node.firstChild(); child; child = child->next()) {
+            collect(*child);
+        }
+    }
+
+    /*
+     * Parsing registers the prefix of each namespace it meets, and saving relies on that to
+     * declare them again, so the prefixes have to be registered on loading too.
+     */
+    void write_prefixes(Writer &w) const
+    {
+        std::vector<std::pair<std::string_view, char const *>> known;
+        for (auto const &prefix : _prefixes) {
+            if (auto uri = sp_xml_ns_prefix_uri(prefix.c_str())) {
+                known.emplace_back(prefix, uri);
+            }
+        }
+        w.write<std::uint32_t>(known.size());
+        for (auto const &[prefix, uri] : known) {
+            w.write_string(prefix);
+            w.write_string(uri);
+        }
+    }
+
+    void write_strings(Writer &w) const
+    {
+        w.write<std::uint32_t>(_strings.size());
+        for (auto const &str : _strings) {
+            w.write_string(str);
+        }
+    }
+
+    void write_node(Writer &w, Node const &node) const
+    {
+        auto const text = dynamic_cast<TextNode const *>(&node);
+        w.write<std::uint8_t>(static_cast<std::uint8_t>(node.type()));
+        w.write<std::uint8_t>(text && text->is_CData() ? FLAG_CDATA : 0);
+        w.write<std::uint32_t>(index(node.name()));
+        w.write<std::uint32_t>(index(node.content()));
+
+        auto const &attrs = node.attributeList();
+        w.write<std::uint32_t>(attrs.size());
+        for (auto const &attr : attrs) {
+            w.write<std::uint32_t>(index(g_quark_to_string(attr.key)));
+            w.write<std::uint32_t>(index(attr.value));
+        }
+
+        w.write<std::uint32_t>(node.childCount());
+        for (auto child = node.firstChild(); child; child = child->next()) {
+            write_node(w, *child);
+        }
+    }
+
+private:
+    std::vector<std::string_view> _strings;
+    std::unordered_map<std::string_view, std::uint32_t> _indices;
+    std::set<std::string> _prefixes;
+
+    void add_prefix(char const *qname)
+    {
+        if (auto colon = qname ? std::strchr(qname, ':') : nullptr) {
+            _prefixes.emplace(qname, colon);
+        }
+    }
+
+    void add(char const *str)
+    {
+        if (str && _indices.emplace(str, _strings.size()).second) {
+            _strings.emplace_back(str);
+        }
+    }
+
+    std::uint32_t index(char const *str) const
+    {
+        return str ? _indices.at(str) : NO_STRING;
+    }
+};
+
+// Rebuilds a tree from the nodes section, using the string table from the mapped file.
+class TreeReader
+{
+public:
+    TreeReader(Reader &r, Document *doc, std::vector<char const *> const &strings)
+        : _r(r), _doc(doc), _strings(strings) {}
+
+    /// Read one node and its descendants, returning nullptr if the data is malformed.
+    Node *read_node()
+    {
+        std::uint8_t type, flags;
+        char const *name, *content;
+        if (!_r.read(type) || !_r.read(flags) || !read_string(name) || !read_string(content)) {
+            return nullptr;
+        }
+
+        Node *node = nullptr;
+        switch (static_cast<NodeType>(type)) {
+            case NodeType::ELEMENT_NODE:
+                if (name) {
+                    node = _doc->createElement(name);
+                }
+                break;
+            case NodeType::TEXT_NODE:
+                node = _doc->createTextNode(content ? content : "", flags & FLAG_CDATA);
+                break;
+            case NodeType::COMMENT_NODE:
+                node = _doc->createComment(content ? content : "");
+                break;
+            case NodeType::PI_NODE:
+                if (name) {
+                    node = _doc->createPI(name, content);
+                }
+                break;
+            default:
+                break;
+        }
+        if (!node) {
+            return nullptr;
+        }
+
+        if (node->type() == NodeType::ELEMENT_NODE && content) {
+            node->setContent(content);
+        }
+
+        if (!read_contents(*node)) {
+            GC::release(node);
+            return nullptr;
+        }
+
+        return node;
+    }
+
+private:
+    Reader &_r;
+    Document *_doc;
+    std::vector<char const *> const &_strings;
+
+    bool read_string(char const *&str)
+    {
+        std::uint32_t i;
+        if (!_r.read(i)) {
+            return false;
+        }
+        if (i == NO_STRING) {
+            str = nullptr;
+            return true;
+        }
+        if (i >= _strings.size()) {
+            return false;
+        }
+        str = _strings[i];
+        return true;
+    }
+
+    bool read_contents(Node &node)
+    {
+        std::uint32_t num_attrs;
+        if (!_r.read(num_attrs)) {
+            return false;
+        }
+        for (std::uint32_t i = 0; i < num_attrs; i++) {
+            char const *key, *value;
+            if (!read_string(key) || !read_string(value) || !key || !*key) {
+                return false;
+            }
+            node.setAttribute(key, value);
+        }
+
+        std::uint32_t num_children;
+        if (!_r.read(num_children)) {
+            return false;
+        }
+        for (std::uint32_t i = 0; i < num_children; i++) {
+            auto const child = read_node();
+            if (!child) {
+                return false;
+            }
+            node.appendChild(child);
+            GC::release(child);
+        }
+
+        return true;
+    }
+};
+
+// Delete the least recently used entries until the cache is within its size limit.
+void prune_cache()
+{
+    auto const limit = static_cast<std::uintmax_t>(Preferences::get()->getIntLimited("/options/documentcache/size", DEFAULT_CACHE_SIZE, 0, 1 << 20)) << 20;
+
+    std::error_code ec;
+    std::vector<std::filesystem::directory_entry> entries;
+    std::uintmax_t total = 0;
+    for (auto const &entry : std::filesystem::directory_iterator(cache_dir(), ec)) {
+        if (entry.is_regular_file(ec)) {
+            total += entry.file_size(ec);
+            entries.push_back(entry);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [&] (auto const &a, auto const &b) {
+        return a.last_write_time(ec) < b.last_write_time(ec);
+    });
+
+    for (auto const &entry : entries) {
+        if (total <= limit) {
+            break;
+        }
+        total -= entry.file_size(ec);
+        std::filesystem::remove(entry.path(), ec);
+    }
+}
+
+} // namespace
+
+DocumentCache::Scope::Scope(std::string filename)
+    : _prev{std::move(scope_filename)}
+{
+    scope_filename = std::move(filename);
+}
+
+DocumentCache::Scope::~Scope()
+{
+    scope_filename = std::move(_prev);
+}
+
+std::optional<DocumentCache> DocumentCache::open(char const *filename, char const *default_ns, bool xinclude)
+{
+    auto prefs = Preferences::get();
+    if (!prefs->getBool("/options/documentcache/enabled", false)) {
+        return {};
+    }
+
+    auto const local_filename = Glib::filename_from_utf8(filename);
+    if (scope_filename.empty() || local_filename != scope_filename) {
+        return {};
+    }
+    auto const mapped = g_mapped_file_new(local_filename.c_str(), false, nullptr);
+    if (!mapped) {
+        return {};
+    }
+    auto unref = scope_exit([&] { g_mapped_file_unref(mapped); });
+
+    auto const size = g_mapped_file_get_length(mapped);
+    if (size < MIN_FILE_SIZE) {
+        return {};
+    }
+
+    auto const hash = g_compute_checksum_for_data(G_CHECKSUM_SHA256, reinterpret_cast<guchar const *>(g_mapped_file_get_contents(mapped)), size);
+
+    auto result = DocumentCache();
+    result._hash = hash;
+    g_free(hash);
+
+    result._params = std::string("ns=") + (default_ns ? default_ns : "")
+                   + ";xinclude=" + (xinclude ? "1" : "0")
+                   + ";clean=" + (prefs->getBool("/options/svgoutput/check_on_reading") ? "1" : "0")
+                   + ";net=" + (prefs->getBool("/options/externalresources/xml/allow_net_access", false) ? "1" : "0");
+
+    auto const key = result._hash + result._params;
+    auto const name = g_compute_checksum_for_string(G_CHECKSUM_SHA256, key.c_str(), key.size());
+    result._path = Glib::build_filename(cache_dir(), std::string(name) + ".bin");
+    g_free(name);
+
+    return result;
+}
+
+Document *DocumentCache::load()
+{
+    auto const start = g_get_monotonic_time();
+
+    auto const mapped = g_mapped_file_new(_path.c_str(), false, nullptr);
+    if (!mapped) {
+        g_info("Document cache miss: %s", _hash.c_str());
+        return nullptr;
+    }
+    auto unref = scope_exit([&] { g_mapped_file_unref(mapped); });
+
+    auto const data = g_mapped_file_get_contents(mapped);
+    auto r = Reader(data, data + g_mapped_file_get_length(mapped));
+
+    auto discard = [&] (char const *reason) -> Document * {
+        g_warning("Discarding document cache entry %s: %s", _path.c_str(), reason);
+        g_remove(_path.c_str());
+        return nullptr;
+    };
+
+    char magic[sizeof(MAGIC)];
+    std::uint32_t version, bom;
+    std::int64_t parse_time;
+    if (!r.read(magic) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        !r.read(version) || version != VERSION ||
+        !r.read(bom) || bom != BYTE_ORDER_MARK ||
+        !r.read(parse_time))
+    {
+        return discard("bad header");
+    }
+
+    auto const hash = r.read_string();
+    auto const params = r.read_string();
+    if (!hash || _hash != hash || !params || _params != params) {
+        return discard("key mismatch");
+    }
+
+    std::uint32_t num_prefixes;
+    if (!r.read(num_prefixes)) {
+        return discard("truncated");
+    }
+    for (std::uint32_t i = 0; i < num_prefixes; i++) {
+        auto const prefix = r.read_string();
+        auto const uri = r.read_string();
+        if (!prefix || !uri) {
+            return discard("truncated");
+        }
+        // The prefix may already be taken by another namespace, in which case parsing would have
+        // renamed the elements and attributes of this one.
+        auto const registered = sp_xml_ns_uri_prefix(uri, prefix);
+        if (!registered || std::strcmp(registered, prefix) != 0) {
+            return discard("namespace prefix mismatch");
+        }
+    }
+
+    std::uint32_t num_strings;
+    if (!r.read(num_strings)) {
+        return discard("truncated");
+    }
+    std::vector<char const *> strings;
+    for (std::uint32_t i = 0; i < num_strings; i++) {
+        auto const str = r.read_string();
+        if (!str) {
+            return discard("truncated");
+        }
+        strings.push_back(str);
+    }
+
+    Document *doc = new SimpleDocument();
+    auto tr = TreeReader(r, doc, strings);
+
+    std::uint32_t num_children;
+    bool ok = r.read(num_children);
+    for (std::uint32_t i = 0; ok && i < num_children; i++) {
+        auto const child = tr.read_node();
+        if (!child) {
+            ok = false;
+            break;
+        }
+        doc->appendChild(child);
+        GC::release(child);
+    }
+    if (!ok || !r.at_end() || !doc->root()) {
+        GC::release(doc);
+        return discard("malformed tree");
+    }
+
+    auto const load_time = g_get_monotonic_time() - start;
+    g_info("Document cache hit: loaded in %.1f ms, saving %.1f ms", load_time / 1000.0, (parse_time - load_time) / 1000.0);
+
+    // Mark as recently used, for pruning.
+    g_utime(_path.c_str(), nullptr);
+
+    return doc;
+}
+
+void DocumentCache::store(Document const *doc, std::int64_t parse_time_us)
+{
+    if (!doc || !doc->root()) {
+        return;
+    }
+
+    auto w = Writer();
+    w.write(MAGIC);
+    w.write(VERSION);
+    w.write(BYTE_ORDER_MARK);
+    w.write<std::int64_t>(parse_time_us);
+    w.write_string(_hash);
+    w.write_string(_params);
+
+    auto tw = TreeWriter();
+    for (auto child = doc->firstChild(); child; child = child->next()) {
+        tw.collect(*child);
+    }
+    tw.write_prefixes(w);
+    tw.write_strings(w);
+
+    w.write<std::uint32_t>(doc->childCount());
+    for (auto child = doc->firstChild(); child; child = child->next()) {
+        tw.write_node(w, *child);
+    }
+
+    g_mkdir_with_parents(cache_dir().c_str(), 0700);
+
+    GError *error = nullptr;
+    if (!g_file_set_contents(_path.c_str(), w.buffer().data(), w.buffer().size(), &error)) {
+        g_warning("Failed to write document cache entry %s: %s", _path.c_str(), error->message);
+        g_error_free(error);
+        return;
+    }
+
+    prune_cache();
+}
+
+} // namespace Inkscape::XML
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
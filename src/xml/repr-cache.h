@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * @brief Binary cache of parsed XML documents, for fast reopening of large files.
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#ifndef SEEN_XML_REPR_CACHE_H
+#define SEEN_XML_REPR_CACHE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace Inkscape::XML {
+
+struct Document;
+
+/**
+ * A sidecar cache of parsed documents, stored in the user cache directory and keyed by a hash of
+ * the file contents together with the settings that affect parsing.
+ *
+ * Entries hold the XML tree after parsing and cleaning in a compact binary form, with a string
+ * table that is used in place from a memory-mapped file. Any mismatch or corruption discards the
+ * entry, and the caller falls back to parsing the file.
+ */
+class DocumentCache
+{
+public:
+    /**
+     * Allows the cache to be used for one file while alive, on this thread.
+     * Only documents opened by the user are worth caching; templates, resources and the output
+     * of extensions are read through the same functions, but are not looked up.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(std::string filename);
+        ~Scope();
+        Scope(Scope const &) = delete;
+        Scope &operator=(Scope const &) = delete;
+
+    private:
+        std::string _prev;
+    };
+
+    /// Prepare to look up the given file. Returns nothing if the cache is disabled, the file is
+    /// not the one a Scope was opened for, or the file is too small to bother.
+    static std::optional<DocumentCache> open(char const *filename, char const *default_ns, bool xinclude);
+
+    /// Load the document from the cache, or return nullptr on a miss.
+    Document *load();
+
+    /// Store a freshly parsed document, recording how long it took to parse.
+    void store(Document const *doc, std::int64_t parse_time_us);
+
+private:
+    DocumentCache() = default;
+
+    std::string _path;   ///< Location of the cache entry.
+    std::string _hash;   ///< Hash of the file contents.
+    std::string _params; ///< Settings the parsed tree depends on.
+};
+
+} // namespace Inkscape::XML
+
+#endif // SEEN_XML_REPR_CACHE_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
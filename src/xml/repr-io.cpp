@@ -21,6 +21,7 @@
 #include "xml/repr.h"
 #include "xml/attribute-record.h"
 #include "xml/rebase-hrefs.h"
+#include "xml/repr-cache.h"
 #include "xml/simple-document.h"
 #include "xml/text-node.h"
 #include "xml/node.h"
@@ -297,6 +298,18 @@ Document *sp_repr_read_file (const gchar * filename, const gchar *default_ns, bo
 
     Inkscape::IO::dump_fopen_call(filename, "N");
 
+    // Large files may have been parsed before and stored in the document cache.
+    auto cache = Inkscape::XML::DocumentCache::open(filename, default_ns, xinclude);
+    if (cache) {
+        rdoc = cache->load();
+        if (rdoc) {
+            g_free(localFilename);
+            return rdoc;
+        }
+    }
+
+    auto const start = g_get_monotonic_time();
+
     XmlSource src;
 
     if (src.setFile(filename) == 0) {
@@ -307,6 +320,10 @@ Document *sp_repr_read_file (const gchar * filename, const gchar *default_ns, bo
         rdoc = sp_repr_do_read(doc, default_ns);
     }
 
+    if (cache && rdoc) {
+        cache->store(rdoc, g_get_monotonic_time() - start);
+    }
+
     if (doc) {
         xmlFreeDoc(doc);
     }
@@ -178,8 +178,6 @@ SimpleNode::SimpleNode(int code, Document *document)
     this->_document = document;
     this->_parent = this->_next = this->_prev = nullptr;
     this->_first_child = this->_last_child = nullptr;
-
-    _observers.add(_subtree_observers);
 }
 
 SimpleNode::SimpleNode(SimpleNode const &node, Document *document)
@@ -213,8 +211,6 @@ SimpleNode::SimpleNode(SimpleNode const &node, Document *document)
     }
 
     _attributes = node._attributes;
-
-    _observers.add(_subtree_observers);
 }
 
 gchar const *SimpleNode::name() const {
@@ -282,12 +278,35 @@ bool SimpleNode::matchAttributeName(gchar const *partial_name) const {
 }
 
 void SimpleNode::_setParent(SimpleNode *parent) {
+    _parent = parent;
+}
+
+SimpleNode::ObserverLists &SimpleNode::_ensureObserverLists() {
+    if (!_observer_lists) {
+        _observer_lists = new ObserverLists();
+    }
+    return *_observer_lists;
+}
+
+/**
+ * Send a notification to the subtree observers of this node and its ancestors, outermost first,
+ * then to the observers of this node.
+ */
+template <typename F>
+void SimpleNode::_notifyObservers(F const &notify) {
+    _notifySubtreeObservers(notify);
+    if (_observer_lists) {
+        notify(_observer_lists->observers);
+    }
+}
+
+template <typename F>
+void SimpleNode::_notifySubtreeObservers(F const &notify) {
     if (_parent) {
-        _subtree_observers.remove(_parent->_subtree_observers);
+        _parent->_notifySubtreeObservers(notify);
     }
-    _parent = parent;
-    if (parent) {
-        _subtree_observers.add(parent->_subtree_observers);
+    if (_observer_lists) {
+        notify(_observer_lists->subtree_observers);
     }
 }
 
@@ -306,7 +325,7 @@ void SimpleNode::setContent(gchar const *content) {
 
     if ( _content != old_content ) {
         _document->logger()->notifyContentChanged(*this, old_content, _content);
-        _observers.notifyContentChanged(*this, old_content, _content);
+        _notifyObservers([&] (NodeObserver &o) { o.notifyContentChanged(*this, old_content, _content); });
     }
 }
 
@@ -390,7 +409,7 @@ SimpleNode::setAttributeImpl(gchar const *name, gchar const *value)
 
     if ( new_value != old_value && (!old_value || !new_value || strcmp(old_value, new_value))) {
         _document->logger()->notifyAttributeChanged(*this, key, old_value, new_value);
-        _observers.notifyAttributeChanged(*this, key, old_value, new_value);
+        _notifyObservers([&] (NodeObserver &o) { o.notifyAttributeChanged(*this, key, old_value, new_value); });
         //g_warning( "setAttribute notified: %s: %s: %s: %s", name, element.c_str(), old_value, new_value ); 
     }
     g_free( cleaned_value );
@@ -407,7 +426,7 @@ void SimpleNode::setCodeUnsafe(int code) {
 
     if (new_code != old_code) {
         _document->logger()->notifyElementNameChanged(*this, old_code, new_code);
-        _observers.notifyElementNameChanged(*this, old_code, new_code);
+        _notifyObservers([&] (NodeObserver &o) { o.notifyElementNameChanged(*this, old_code, new_code); });
     }
 }
 
@@ -457,7 +476,7 @@ void SimpleNode::addChild(Node *generic_child, Node *generic_ref) {
     _child_count++;
 
     _document->logger()->notifyChildAdded(*this, *child, ref);
-    _observers.notifyChildAdded(*this, *child, ref);
+    _notifyObservers([&] (NodeObserver &o) { o.notifyChildAdded(*this, *child, ref); });
 }
 
 void SimpleNode::removeChild(Node *generic_child) {
@@ -491,7 +510,7 @@ void SimpleNode::removeChild(Node *generic_child) {
     _child_count--;
 
     _document->logger()->notifyChildRemoved(*this, *child, ref);
-    _observers.notifyChildRemoved(*this, *child, ref);
+    _notifyObservers([&] (NodeObserver &o) { o.notifyChildRemoved(*this, *child, ref); });
 }
 
 void SimpleNode::changeOrder(Node *generic_child, Node *generic_ref) {
@@ -548,7 +567,7 @@ void SimpleNode::changeOrder(Node *generic_child, Node *generic_ref) {
     _cached_positions_valid = false;
 
     _document->logger()->notifyChildOrderChanged(*this, *child, prev, ref);
-    _observers.notifyChildOrderChanged(*this, *child, prev, ref);
+    _notifyObservers([&] (NodeObserver &o) { o.notifyChildOrderChanged(*this, *child, prev, ref); });
 }
 
 void SimpleNode::setPosition(int pos) {
@@ -98,17 +98,21 @@ public:
     void synthesizeEvents(NodeObserver &observer) override;
 
     void addObserver(NodeObserver &observer) override {
-        _observers.add(observer);
+        _ensureObserverLists().observers.add(observer);
     }
     void removeObserver(NodeObserver &observer) override {
-        _observers.remove(observer);
+        if (_observer_lists) {
+            _observer_lists->observers.remove(observer);
+        }
     }
 
     void addSubtreeObserver(NodeObserver &observer) override {
-        _subtree_observers.add(observer);
+        _ensureObserverLists().subtree_observers.add(observer);
     }
     void removeSubtreeObserver(NodeObserver &observer) override {
-        _subtree_observers.remove(observer);
+        if (_observer_lists) {
+            _observer_lists->subtree_observers.remove(observer);
+        }
     }
 
     void recursivePrintTree(unsigned level = 0) override;
@@ -126,6 +130,15 @@ private:
     void _setParent(SimpleNode *parent);
     unsigned _childPosition(SimpleNode const &child) const;
 
+    struct ObserverLists : public Inkscape::GC::Managed<>
+    {
+        CompositeNodeObserver observers;
+        CompositeNodeObserver subtree_observers;
+    };
+    ObserverLists &_ensureObserverLists();
+    template <typename F> void _notifyObservers(F const &notify);
+    template <typename F> void _notifySubtreeObservers(F const &notify);
+
     SimpleNode *_parent;
     SimpleNode *_next;
     SimpleNode *_prev;
@@ -143,8 +156,8 @@ private:
     SimpleNode *_first_child;
     SimpleNode *_last_child;
 
-    CompositeNodeObserver _observers;
-    CompositeNodeObserver _subtree_observers;
+    // Allocated on first use, since most nodes are never observed.
+    ObserverLists *_observer_lists = nullptr;
 };
 
 }
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Boolean union benchmark.
+ *
+ * Unions a grid of overlapping circles, as Path > Union does for a large selection, and times
+ * combining their polygons folded one by one in selection order and in a balanced tree. Both are
+ * timed at growing operand counts around and above BOOLOP_TREE_MIN_OPERANDS, the count from which
+ * the tree is used, so the table shows where the tree starts to pay off.
+ *
+ * Usage: boolop_benchmark [CIRCLES]
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2026 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <2geom/circle.h>
+#include <2geom/path.h>
+#include <2geom/pathvector.h>
+#include <glib.h>
+
+#include "livarot/Path.h"
+#include "livarot/Shape.h"
+#include "path/path-boolop.h"
+
+namespace {
+
+// The circles are laid out on a square grid, each overlapping its neighbours.
+constexpr double SPACING = 10.0;
+constexpr double RADIUS = 7.0;
+
+// The polygons of count circles, converted the way _pathBoolOp converts its operands.
+std::vector<std::unique_ptr<Shape>> make_shapes(int count)
+{
+    int const columns = std::ceil(std::sqrt(count));
+
+    std::vector<std::unique_ptr<Shape>> shapes;
+    for (int i = 0; i < count; i++) {
+        auto const center = Geom::Point(i % columns, i / columns) * SPACING;
+        auto const pathv = Geom::PathVector(Geom::Path(Geom::Circle(center, RADIUS)));
+
+        Path path;
+        path.LoadPathVector(pathv);
+        path.ConvertWithBackData(0.1, true);
+
+        Shape polygon;
+        path.Fill(&polygon, i);
+        shapes.push_back(std::make_unique<Shape>());
+        shapes.back()->ConvertToShape(&polygon, fill_nonZero);
+    }
+    return shapes;
+}
+
+// Union count circles and return the time taken in milliseconds, and the edges of the result.
+double time_union(int count, int tree_min_operands, int &edges)
+{
+    auto shapes = make_shapes(count);
+
+    auto const start = g_get_monotonic_time();
+    boolop_shapes(shapes, bool_op_union, tree_min_operands);
+    auto const ms = (g_get_monotonic_time() - start) / 1000.0;
+
+    edges = shapes[0]->numberOfEdges();
+    return ms;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int const circles = argc > 1 ? std::atoi(argv[1]) : 10000;
+
+    std::printf("tree used from %d operands\n", BOOLOP_TREE_MIN_OPERANDS);
+    std::printf("%8s %12s %12s %9s %8s\n", "circles", "serial", "tree", "speedup", "used");
+
+    std::vector<int> counts;
+    for (int count = 4; count < circles; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(circles);
+
+    for (auto count : counts) {
+        int serial_edges = 0;
+        int tree_edges = 0;
+        auto const serial = time_union(count, INT_MAX, serial_edges);
+        auto const tree = time_union(count, 0, tree_edges);
+
+        std::printf("%8d %9.2f ms %9.2f ms %8.2fx %8s", count, serial, tree, tree > 0 ? serial / tree : 0.0,
+                    count >= BOOLOP_TREE_MIN_OPERANDS ? "tree" : "serial");
+        if (serial_edges != tree_edges) {
+            std::printf("   (%d edges serial, %d tree)", serial_edges, tree_edges);
+        }
+        std::printf("\n");
+    }
+
+    return 0;
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: expandtab:shiftwidth=4:tabstop=8:softtabstop=4 :
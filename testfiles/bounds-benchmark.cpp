@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Bounding box benchmark.
+ *
+ * Builds a document of nested groups and times asking every item for its document bounds, the
+ * way selection, snapping and alignment do, once with the bounds caches in use and once with
+ * them invalidated before every query.
+ *
+ * Usage: bounds_benchmark [DEPTH] [FANOUT]
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2026 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <giomm/init.h>
+#include <glib.h>
+
+#include "document.h"
+#include "inkscape.h"
+#include "inkgc/gc-core.h"
+#include "object/sp-item.h"
+#include "object/sp-root.h"
+#include "util/statics.h"
+
+namespace {
+
+constexpr int ROUNDS = 10;
+
+// Keeps the queries from being optimised away.
+double volatile sink;
+
+void append_group(std::string &svg, int depth, int fanout)
+{
+    if (depth == 0) {
+        svg += R"(<rect x="0" y="0" width="10" height="10" style="stroke:black;stroke-width:1"/>)";
+        return;
+    }
+    for (int i = 0; i < fanout; i++) {
+        svg += "<g transform=\"translate(" + std::to_string(i * 3) + ",1) rotate(5)\">";
+        append_group(svg, depth - 1, fanout);
+        svg += "</g>";
+    }
+}
+
+std::string make_document(int depth, int fanout)
+{
+    std::string svg = R"(<svg xmlns="http://www.w3.org/2000/svg" width="1000" height="1000">)";
+    append_group(svg, depth, fanout);
+    svg += "</svg>";
+    return svg;
+}
+
+void collect_items(SPObject *object, std::vector<SPItem *> &items)
+{
+    for (auto &child : object->children) {
+        if (auto item = cast<SPItem>(&child)) {
+            items.push_back(item);
+            collect_items(item, items);
+        }
+    }
+}
+
+// Query the document bounds of every item and return the time taken in milliseconds.
+double time_queries(SPDocument *doc, std::vector<SPItem *> const &items, bool cached)
+{
+    auto const start = g_get_monotonic_time();
+
+    for (int round = 0; round < ROUNDS; round++) {
+        for (auto item : items) {
+            if (!cached) {
+                doc->geometry_epoch++;
+            }
+            if (auto bbox = item->documentVisualBounds()) {
+                sink = bbox->width();
+            }
+            sink = item->i2doc_affine().det();
+        }
+    }
+
+    return (g_get_monotonic_time() - start) / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Gio::init();
+    Inkscape::GC::init();
+    Inkscape::Application::create(false);
+
+    int const depth = argc > 1 ? std::atoi(argv[1]) : 6;
+    int const fanout = argc > 2 ? std::atoi(argv[2]) : 4;
+
+    auto const svg = make_document(depth, fanout);
+    auto doc = SPDocument::createNewDocFromMem(svg, false);
+    if (!doc) {
+        std::fprintf(stderr, "failed to create document\n");
+        return 1;
+    }
+    doc->ensureUpToDate();
+
+    std::vector<SPItem *> items;
+    collect_items(doc->getRoot(), items);
+
+    auto const uncached = time_queries(doc.get(), items, false);
+    auto const cached = time_queries(doc.get(), items, true);
+
+    std::printf("depth %d, fanout %d, %zu items, %d rounds\n", depth, fanout, items.size(), ROUNDS);
+    std::printf("%-10s %10.2f ms\n", "uncached", uncached);
+    std::printf("%-10s %10.2f ms\n", "cached", cached);
+    if (cached > 0) {
+        std::printf("%-10s %10.1fx\n", "speedup", uncached / cached);
+    }
+
+    doc.reset();
+    Inkscape::Util::StaticsBin::get().destroy();
+    return 0;
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: expandtab:shiftwidth=4:tabstop=8:softtabstop=4 :
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Paint bucket fill benchmark.
+ *
+ * Times filling rendered bitmaps the way the paint bucket fills the rendered canvas, with the
+ * span fill it uses without autogap and with the queue based fill it uses for autogap (with no
+ * gap closing, so both fill the same pixels). Two drawings are filled at growing sizes: an open
+ * area, and a serpentine corridor whose walls leave a gap at alternating ends.
+ *
+ * Usage: flood_benchmark [SIZE]
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2026 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <glib.h>
+
+#include "ui/tools/flood-tool.h"
+
+using namespace Inkscape::UI::Tools;
+
+namespace {
+
+constexpr std::uint32_t WHITE = 0xffffffff;
+constexpr std::uint32_t BLACK = 0xff000000;
+
+// Rows between the walls of the corridor.
+constexpr int CORRIDOR = 8;
+
+// An ARGB32 bitmap of the given size, with a border; with corridor set, also the corridor walls.
+std::vector<std::uint32_t> draw(int size, bool corridor)
+{
+    std::vector<std::uint32_t> px(size * size, WHITE);
+    for (int i = 0; i < size; i++) {
+        px[i] = px[(size - 1) * size + i] = BLACK;
+        px[i * size] = px[i * size + size - 1] = BLACK;
+    }
+    if (corridor) {
+        for (int y = CORRIDOR, n = 0; y < size - 1; y += CORRIDOR, n++) {
+            int const gap = n % 2 == 0 ? size - 3 : 1;
+            for (int x = 1; x < size - 1; x++) {
+                if (x != gap) {
+                    px[y * size + x] = BLACK;
+                }
+            }
+        }
+    }
+    return px;
+}
+
+// Fill from the top left corner and return the time taken in milliseconds, and the filled pixels.
+double time_fill(int size, bool corridor, bool queue, long &filled)
+{
+    auto px = draw(size, corridor);
+    auto const data = reinterpret_cast<unsigned char *>(px.data());
+
+    auto const start = g_get_monotonic_time();
+    filled = flood_fill_bitmap(data, size, size, size * 4, {2, 2}, FLOOD_CHANNELS_RGB, 2, queue);
+    return (g_get_monotonic_time() - start) / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int const max_size = argc > 1 ? std::atoi(argv[1]) : 4096;
+
+    std::printf("%-10s %8s %12s %12s %9s %12s\n", "drawing", "size", "span", "queue", "speedup", "pixels");
+    for (bool corridor : {false, true}) {
+        for (int size = 512; size <= max_size; size *= 2) {
+            long span_filled = 0;
+            long queue_filled = 0;
+            auto const span = time_fill(size, corridor, false, span_filled);
+            auto const queue = time_fill(size, corridor, true, queue_filled);
+
+            std::printf("%-10s %8d %9.2f ms %9.2f ms %8.2fx %12ld", corridor ? "corridor" : "open", size, span,
+                        queue, span > 0 ? queue / span : 0.0, span_filled);
+            if (span_filled != queue_filled) {
+                std::printf("   (queue filled %ld)", queue_filled);
+            }
+            std::printf("\n");
+        }
+    }
+
+    return 0;
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: expandtab:shiftwidth=4:tabstop=8:softtabstop=4 :
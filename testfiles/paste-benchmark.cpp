@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Paste id clash benchmark.
+ *
+ * Times resolving the id clashes of a paste in which every object clashes with one already in
+ * the document: rect/use pairs pasted into a document that holds the same pairs, so every id
+ * is renamed and every reference follows its renamed object. The paste is repeated at growing
+ * sizes, up to the given number of objects, so that the time per object shows how it scales.
+ *
+ * Usage: paste_benchmark [OBJECTS]
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2026 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <giomm/init.h>
+#include <glib.h>
+
+#include "document.h"
+#include "id-clash.h"
+#include "inkscape.h"
+#include "inkgc/gc-core.h"
+#include "util/statics.h"
+
+namespace {
+
+// A document with count rect/use pairs, "rect0".."rect<count-1>" and the uses referencing them.
+std::unique_ptr<SPDocument> make_document(int count)
+{
+    std::string svg = R"(<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink">)";
+    for (int i = 0; i < count; i++) {
+        auto const id = "rect" + std::to_string(i);
+        svg += "<rect id=\"" + id + "\" width=\"1\" height=\"1\"/>";
+        svg += "<use id=\"use" + std::to_string(i) + "\" xlink:href=\"#" + id + "\"/>";
+    }
+    svg += "</svg>";
+    return SPDocument::createNewDocFromMem(svg, false);
+}
+
+// Resolve the clashes of pasting count pairs and return the time taken in milliseconds.
+double time_paste(int count)
+{
+    auto current = make_document(count);
+    auto pasted = make_document(count);
+    if (!current || !pasted) {
+        return -1;
+    }
+
+    auto const start = g_get_monotonic_time();
+    prevent_id_clashes(pasted.get(), current.get(), true);
+    return (g_get_monotonic_time() - start) / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Gio::init();
+    Inkscape::GC::init();
+    Inkscape::Application::create(false);
+
+    int const objects = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    std::printf("%10s %12s %14s\n", "objects", "time", "per object");
+    for (int pairs = std::max(objects / 16, 1); pairs <= objects / 2; pairs *= 2) {
+        auto const ms = time_paste(pairs);
+        if (ms < 0) {
+            std::fprintf(stderr, "failed to create documents\n");
+            return 1;
+        }
+        std::printf("%10d %9.2f ms %11.2f us\n", 2 * pairs, ms, ms * 1000.0 / (2 * pairs));
+    }
+
+    Inkscape::Util::StaticsBin::get().destroy();
+    return 0;
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: expandtab:shiftwidth=4:tabstop=8:softtabstop=4 :
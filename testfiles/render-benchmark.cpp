@@ -0,0 +1,266 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Headless canvas rendering benchmark.
+ *
+ * Renders a scripted sequence of zooms and pans over each input file, tile by tile as the canvas
+ * would, and reports the number of tiles painted and the median and 95th percentile frame times.
+ * With no arguments, runs over the files in testfiles/rendering_tests.
+ *
+ * Usage: render_benchmark [--trace=FILE] [FILE.svg...]
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2026 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <cairomm/region.h>
+#include <cairomm/surface.h>
+#include <giomm/init.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+#include <glibmm/stringutils.h>
+#include <2geom/int-rect.h>
+#include <2geom/transforms.h>
+
+#include "document.h"
+#include "inkscape.h"
+#include "display/cairo-utils.h"
+#include "display/drawing.h"
+#include "display/drawing-context.h"
+#include "display/drawing-surface.h"
+#include "inkgc/gc-core.h"
+#include "object/sp-root.h"
+#include "ui/widget/canvas/framecheck.h"
+#include "util/statics.h"
+
+namespace {
+
+constexpr int VIEW_WIDTH = 1280;
+constexpr int VIEW_HEIGHT = 800;
+constexpr int TILE_SIZE = 300;
+constexpr int ZOOM_STEPS = 12;
+constexpr double ZOOM_FACTOR = 1.25;
+constexpr int PAN_STEPS = 24;
+constexpr int PAN_STEP = 40;
+
+struct Frame
+{
+    Geom::Affine affine;
+    Geom::IntRect view;
+};
+
+// Zoom in about the centre of the drawing, pan around in a circle, then zoom back out.
+std::vector<Frame> make_script(Geom::Rect const &bounds)
+{
+    std::vector<Frame> frames;
+
+    auto const fit = std::min(VIEW_WIDTH / bounds.width(), VIEW_HEIGHT / bounds.height());
+    auto const centre = bounds.midpoint();
+
+    auto frame = [&] (double zoom, Geom::IntPoint const &pan) {
+        auto const affine = Geom::Scale(zoom);
+        auto const mid = (centre * affine).round() + pan;
+        frames.push_back({ affine, Geom::IntRect::from_xywh(mid.x() - VIEW_WIDTH / 2, mid.y() - VIEW_HEIGHT / 2, VIEW_WIDTH, VIEW_HEIGHT) });
+    };
+
+    for (int i = 0; i <= ZOOM_STEPS; i++) {
+        frame(fit * std::pow(ZOOM_FACTOR, i), {0, 0});
+    }
+
+    auto const zoom = fit * std::pow(ZOOM_FACTOR, ZOOM_STEPS);
+    for (int i = 1; i <= PAN_STEPS; i++) {
+        auto const angle = 2 * M_PI * i / PAN_STEPS;
+        auto const radius = PAN_STEP * PAN_STEPS / (2 * M_PI);
+        frame(zoom, Geom::Point(radius * (std::cos(angle) - 1), radius * std::sin(angle)).round());
+    }
+
+    for (int i = ZOOM_STEPS; i >= 0; i--) {
+        frame(fit * std::pow(ZOOM_FACTOR, i), {0, 0});
+    }
+
+    return frames;
+}
+
+class Benchmark
+{
+public:
+    explicit Benchmark(SPDocument *doc)
+        : root(doc->getRoot())
+    {
+        dkey = SPItem::display_key_new(1);
+        drawing.setRoot(root->invoke_show(drawing, dkey, SP_ITEM_SHOW_DISPLAY));
+    }
+
+    ~Benchmark()
+    {
+        root->invoke_hide(dkey);
+    }
+
+    // Render one frame, painting only what the canvas would have to, and return its duration in microseconds.
+    gint64 render(Frame const &frame)
+    {
+        auto const start = g_get_monotonic_time();
+
+        drawing.setCacheLimit(frame.view);
+
+        auto region = Cairo::Region::create(geom_to_cairo(frame.view));
+        if (prev && prev->affine == frame.affine) {
+            // Panning: the canvas keeps what it has already drawn and only paints the exposed strips.
+            region->subtract(geom_to_cairo(prev->view));
+        } else {
+            drawing.update(Geom::IntRect::infinite(), frame.affine, Inkscape::DrawingItem::STATE_ALL, Inkscape::DrawingItem::STATE_ALL);
+        }
+
+        for (int i = 0; i < region->get_num_rectangles(); i++) {
+            auto const rect = cairo_to_geom(region->get_rectangle(i));
+            for (int y = rect.top(); y < rect.bottom(); y += TILE_SIZE) {
+                for (int x = rect.left(); x < rect.right(); x += TILE_SIZE) {
+                    auto const tile = Geom::IntRect(x, y, std::min(x + TILE_SIZE, rect.right()), std::min(y + TILE_SIZE, rect.bottom()));
+                    paint_tile(tile);
+                }
+            }
+        }
+
+        prev = frame;
+        return g_get_monotonic_time() - start;
+    }
+
+    long tiles_painted() const { return tiles; }
+
+private:
+    void paint_tile(Geom::IntRect const &rect)
+    {
+        auto const cs = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, rect.width(), rect.height());
+        auto ds = Inkscape::DrawingSurface(cs->cobj(), rect.min());
+        auto dc = Inkscape::DrawingContext(ds);
+        Inkscape::FrameCheck::Event fc("paint_rect");
+        drawing.render(dc, rect);
+        tiles++;
+    }
+
+    Inkscape::Drawing drawing;
+    SPRoot *root;
+    unsigned dkey;
+    std::optional<Frame> prev;
+    long tiles = 0;
+};
+
+double percentile(std::vector<gint64> times, double p)
+{
+    std::sort(times.begin(), times.end());
+    auto const i = std::clamp<std::size_t>(std::ceil(p * times.size()), 1, times.size()) - 1;
+    return times[i] / 1000.0;
+}
+
+std::vector<std::string> default_files()
+{
+    std::vector<std::string> files;
+    auto const dir = std::string(INKSCAPE_TESTS_DIR "/rendering_tests");
+    for (auto const &name : Glib::Dir(dir)) {
+        if (Glib::str_has_suffix(name, ".svg")) {
+            files.push_back(Glib::build_filename(dir, name));
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Gio::init();
+    Inkscape::GC::init();
+    Inkscape::Application::create(false);
+    Inkscape::FrameCheck::set_enabled(true);
+
+    std::string trace_path;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        auto const arg = std::string(argv[i]);
+        if (arg.starts_with("--trace=")) {
+            trace_path = arg.substr(8);
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        files = default_files();
+    }
+
+    std::vector<gint64> all_times;
+    long all_tiles = 0;
+    std::printf("%-40s %7s %7s %10s %10s\n", "file", "frames", "tiles", "p50 (ms)", "p95 (ms)");
+
+    for (auto const &file : files) {
+        auto doc = std::unique_ptr<SPDocument>(SPDocument::createNewDoc(file.c_str(), false));
+        if (!doc) {
+            std::fprintf(stderr, "%s: failed to load\n", file.c_str());
+            continue;
+        }
+        doc->ensureUpToDate();
+
+        auto bounds = doc->getRoot()->documentVisualBounds();
+        if (!bounds || bounds->hasZeroArea()) {
+            bounds = Geom::Rect({0, 0}, doc->getDimensions());
+        }
+        if (bounds->hasZeroArea()) {
+            continue;
+        }
+
+        std::vector<gint64> times;
+        long tiles = 0;
+        {
+            auto bench = Benchmark(doc.get());
+            for (auto const &frame : make_script(*bounds)) {
+                times.push_back(bench.render(frame));
+            }
+            tiles = bench.tiles_painted();
+        }
+
+        std::printf("%-40s %7zu %7ld %10.2f %10.2f\n", Glib::path_get_basename(file).c_str(), times.size(), tiles, percentile(times, 0.5), percentile(times, 0.95));
+        all_times.insert(all_times.end(), times.begin(), times.end());
+        all_tiles += tiles;
+    }
+
+    if (!all_times.empty()) {
+        std::printf("%-40s %7zu %7ld %10.2f %10.2f\n", "total", all_times.size(), all_tiles, percentile(all_times, 0.5), percentile(all_times, 0.95));
+    }
+
+    std::printf("\n");
+    for (auto const &[name, value] : Inkscape::FrameCheck::get_counters()) {
+        // Tiles are painted here rather than by a canvas, so its counters would only ever read zero.
+        if (name.starts_with("canvas-")) {
+            continue;
+        }
+        std::printf("%s=%lld\n", name.c_str(), static_cast<long long>(value));
+    }
+
+    if (!trace_path.empty()) {
+        auto f = std::ofstream(trace_path, std::ios_base::out | std::ios_base::binary);
+        Inkscape::FrameCheck::write_chrome_trace(f);
+    }
+
+    Inkscape::Util::StaticsBin::get().destroy();
+    return all_times.empty() ? 1 : 0;
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: expandtab:shiftwidth=4:tabstop=8:softtabstop=4 :
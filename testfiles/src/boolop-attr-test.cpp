@@ -15,6 +15,7 @@
 
 #include "doc-per-case-test.h"
 #include "object/object-set.h"
+#include "svg/svg.h"
 
 using namespace Inkscape;
 using namespace std::literals;
@@ -73,3 +74,33 @@ TEST_F(BoolopAttrTest, Union)
     ASSERT_TRUE(combined);
     ASSERT_STREQ(combined->getAttribute("d"), d_combined);
 }
+
+TEST_F(BoolopAttrTest, UnionMany)
+{
+    // enough operands to take the balanced, parallel union path
+    auto svg = std::string{R"A(<svg viewBox="0 0 400 40" xmlns="http://www.w3.org/2000/svg">)A"};
+    for (int i = 0; i < 40; i++) {
+        svg += "<circle cx=\"" + std::to_string(10 + 8 * i) + "\" cy=\"20\" r=\"10\" />";
+    }
+    svg += "</svg>";
+    auto manydoc = SPDocument::createNewDocFromMem(svg, false);
+
+    auto const circles = manydoc->getObjectsBySelector("circle");
+    ASSERT_EQ(circles.size(), 40);
+
+    auto object_set = ObjectSet(manydoc.get());
+    object_set.setList(circles);
+    object_set.pathUnion(true);
+
+    auto combined = object_set.single();
+    ASSERT_TRUE(combined);
+
+    auto const pathv = sp_svg_read_pathv(combined->getAttribute("d"));
+    ASSERT_EQ(pathv.size(), 1);
+    auto const bounds = pathv.boundsExact();
+    ASSERT_TRUE(bounds);
+    EXPECT_NEAR(bounds->left(), 0, 0.01);
+    EXPECT_NEAR(bounds->right(), 332, 0.01);
+    EXPECT_NEAR(bounds->top(), 10, 0.01);
+    EXPECT_NEAR(bounds->bottom(), 30, 0.01);
+}
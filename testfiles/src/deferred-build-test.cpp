@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Tests for building documents lazily
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
+ */
+
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include "document.h"
+#include "inkscape.h"
+#include "object/deferred-build.h"
+#include "object/sp-defs.h"
+#include "object/sp-item-group.h"
+#include "object/sp-marker.h"
+#include "style.h"
+#include "xml/repr.h"
+
+using namespace Inkscape;
+using namespace std::literals;
+
+class DeferredBuildTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // setup hidden dependency
+        Application::create(false);
+
+        constexpr auto svg = R"A(
+<svg xmlns="http://www.w3.org/2000/svg" xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape" width="100" height="100">
+  <defs>
+    <linearGradient id="used"><stop offset="0" style="stop-color:red"/></linearGradient>
+    <linearGradient id="unused"><stop offset="0" style="stop-color:blue"/></linearGradient>
+    <linearGradient id="chained" xlink:href="#used" xmlns:xlink="http://www.w3.org/1999/xlink"/>
+    <symbol id="sym"><rect id="symrect" width="10" height="10"/></symbol>
+    <marker id="mark"><path d="M 0,0 L 1,1"/></marker>
+  </defs>
+  <g id="visible" inkscape:groupmode="layer">
+    <rect id="r1" class="lit" width="10" height="10" style="fill:url(#chained)"/>
+  </g>
+  <g id="hidden" inkscape:groupmode="layer" style="display:none">
+    <rect id="r2" class="tagged" width="10" height="10"/>
+    <g id="nested"><rect id="r3" width="10" height="10"/></g>
+  </g>
+  <g id="styled" inkscape:groupmode="layer" style="display:none">
+    <g id="sheet"><style>.lit { opacity: 0.5 }</style></g>
+  </g>
+</svg>
+        )A"sv;
+
+        auto const lazy = SPDocument::lazy_build_scope();
+        doc = SPDocument::createNewDocFromMem(svg, false);
+        ASSERT_TRUE(doc);
+        deferred = doc->getDeferredBuild();
+        ASSERT_TRUE(deferred);
+    }
+
+    XML::Node *node(char const *id)
+    {
+        return sp_repr_lookup_descendant(doc->getReprRoot(), "id", id);
+    }
+
+    std::unique_ptr<SPDocument> doc;
+    DeferredBuild *deferred = nullptr;
+};
+
+TEST_F(DeferredBuildTest, unusedDefinitionsAreNotBuilt)
+{
+    // Referenced from the drawing, directly or through another gradient.
+    EXPECT_FALSE(deferred->contains(node("used")));
+    EXPECT_FALSE(deferred->contains(node("chained")));
+
+    EXPECT_TRUE(deferred->contains(node("unused")));
+    EXPECT_TRUE(deferred->contains(node("sym")));
+}
+
+TEST_F(DeferredBuildTest, markersAreBuilt)
+{
+    // The marker lists in the UI walk the children of <defs>.
+    EXPECT_FALSE(deferred->contains(node("mark")));
+    auto const &defs = doc->getDefs()->children;
+    EXPECT_TRUE(std::any_of(defs.begin(), defs.end(), [] (auto const &child) {
+        return is<SPMarker>(&child) && child.getId() == "mark"sv;
+    }));
+}
+
+TEST_F(DeferredBuildTest, hiddenLayerContentsAreNotBuilt)
+{
+    auto hidden = cast<SPGroup>(doc->getObjectById("hidden"));
+    ASSERT_TRUE(hidden);
+    EXPECT_FALSE(hidden->hasChildren());
+    EXPECT_TRUE(deferred->contains(node("r2")));
+    EXPECT_TRUE(deferred->contains(node("nested")));
+
+    auto visible = cast<SPGroup>(doc->getObjectById("visible"));
+    ASSERT_TRUE(visible);
+    EXPECT_TRUE(visible->hasChildren());
+}
+
+TEST_F(DeferredBuildTest, stylesheetsInHiddenLayersAreBuilt)
+{
+    EXPECT_FALSE(deferred->contains(node("sheet")));
+
+    auto r1 = doc->getObjectById("r1");
+    ASSERT_TRUE(r1);
+    EXPECT_FLOAT_EQ(SP_SCALE24_TO_FLOAT(r1->style->opacity.value), 0.5);
+}
+
+TEST_F(DeferredBuildTest, lookupByIdBuildsObject)
+{
+    auto sym = doc->getObjectById("symrect");
+    ASSERT_TRUE(sym);
+    EXPECT_FALSE(deferred->contains(node("sym")));
+    EXPECT_TRUE(doc->getObjectById("sym"));
+
+    auto r3 = doc->getObjectById("r3");
+    ASSERT_TRUE(r3);
+    EXPECT_EQ(r3->parent, doc->getObjectById("nested"));
+    EXPECT_EQ(r3->parent->parent, doc->getObjectById("hidden"));
+}
+
+TEST_F(DeferredBuildTest, lookupByReprBuildsObject)
+{
+    auto r2 = doc->getObjectByRepr(node("r2"));
+    ASSERT_TRUE(r2);
+    EXPECT_EQ(r2->getId(), "r2"sv);
+}
+
+TEST_F(DeferredBuildTest, childrenKeepDocumentOrder)
+{
+    // Build the later sibling first.
+    ASSERT_TRUE(doc->getObjectById("nested"));
+    ASSERT_TRUE(doc->getObjectById("r2"));
+
+    auto hidden = doc->getObjectById("hidden");
+    ASSERT_EQ(hidden->children.size(), 2u);
+    EXPECT_EQ(hidden->firstChild()->getId(), "r2"sv);
+    EXPECT_EQ(hidden->lastChild()->getId(), "nested"sv);
+}
+
+TEST_F(DeferredBuildTest, resourceListBuildsMatchingKind)
+{
+    auto gradients = doc->getResourceList("gradient");
+    EXPECT_EQ(gradients.size(), 3u);
+    EXPECT_FALSE(deferred->contains(node("unused")));
+    EXPECT_TRUE(deferred->contains(node("sym")));
+}
+
+TEST_F(DeferredBuildTest, searchesFindDeferredObjects)
+{
+    auto by_class = doc->getObjectsByClass("tagged");
+    ASSERT_EQ(by_class.size(), 1u);
+    EXPECT_EQ(by_class[0]->getId(), "r2"sv);
+
+    EXPECT_EQ(doc->getObjectsBySelector(".tagged").size(), 1u);
+    EXPECT_EQ(doc->getObjectsByElement("symbol").size(), 1u);
+    EXPECT_TRUE(deferred->empty());
+}
+
+TEST_F(DeferredBuildTest, showingLayerBuildsContents)
+{
+    auto hidden = cast<SPGroup>(doc->getObjectById("hidden"));
+    ASSERT_TRUE(hidden);
+    hidden->setAttribute("style", "display:inline");
+    doc->ensureUpToDate();
+
+    EXPECT_EQ(hidden->children.size(), 2u);
+    EXPECT_FALSE(deferred->contains(node("r2")));
+}
+
+TEST_F(DeferredBuildTest, editsToDeferredNodesAreTracked)
+{
+    node("r2")->setAttribute("id", "renamed");
+    EXPECT_FALSE(doc->getObjectById("r2"));
+    EXPECT_TRUE(deferred->contains(node("renamed")));
+
+    auto renamed = doc->getObjectById("renamed");
+    ASSERT_TRUE(renamed);
+    EXPECT_EQ(renamed->getRepr(), node("renamed"));
+}
+
+TEST_F(DeferredBuildTest, removedNodesAreForgotten)
+{
+    auto unused = node("unused");
+    unused->parent()->removeChild(unused);
+    EXPECT_FALSE(deferred->contains(unused));
+    EXPECT_FALSE(doc->getObjectById("unused"));
+}
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Tests for resolving ID clashes when importing or pasting.
+ *
+ * Copyright (C) 2026 Authors
+ *
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+
+#include <src/document.h>
+#include <src/id-clash.h>
+#include <src/inkscape.h>
+#include <src/object/sp-root.h>
+#include <src/object/sp-object.h>
+
+using namespace Inkscape;
+
+class IdClashTest : public ::testing::Test {
+public:
+    static void SetUpTestCase() {
+        Inkscape::Application::create(false);
+    }
+
+    /// A document with \a count rects "rect0".."rect<count-1>", each with a use referencing it.
+    static std::unique_ptr<SPDocument> createDoc(int count) {
+        std::string svg = R"A(<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink">)A";
+        for (int i = 0; i < count; i++) {
+            auto const id = "rect" + std::to_string(i);
+            svg += "<rect id=\"" + id + "\" width=\"1\" height=\"1\"/>";
+            svg += "<use id=\"use" + std::to_string(i) + "\" xlink:href=\"#" + id + "\"/>";
+        }
+        svg += "</svg>";
+        return SPDocument::createNewDocFromMem(svg, false);
+    }
+};
+
+TEST_F(IdClashTest, SimilarUniqueId)
+{
+    auto doc = createDoc(1);
+    ASSERT_TRUE(doc);
+
+    EXPECT_EQ(generate_similar_unique_id(doc.get(), "free"), "free");
+    EXPECT_EQ(generate_similar_unique_id(doc.get(), "rect0"), "rect0-1");
+
+    doc->getObjectById("rect0")->setAttribute("id", "rect-5");
+    EXPECT_EQ(generate_similar_unique_id(doc.get(), "rect-5"), "rect-6");
+    EXPECT_EQ(generate_similar_unique_id(doc.get(), "rect-5"), "rect-7");
+}
+
+TEST_F(IdClashTest, ManyClashingIds)
+{
+    constexpr int count = 2000;
+    auto current = createDoc(count);
+    auto imported = createDoc(count);
+    ASSERT_TRUE(current);
+    ASSERT_TRUE(imported);
+
+    prevent_id_clashes(imported.get(), current.get(), true);
+
+    std::set<std::string> ids;
+    for (int i = 0; i < count; i++) {
+        auto const rect = imported->getRoot()->nthChild(2 * i);
+        auto const use = imported->getRoot()->nthChild(2 * i + 1);
+        ASSERT_TRUE(rect && rect->getId() && use && use->getId());
+
+        EXPECT_FALSE(current->getObjectById(rect->getId()));
+        EXPECT_FALSE(current->getObjectById(use->getId()));
+        EXPECT_TRUE(ids.insert(rect->getId()).second);
+        EXPECT_TRUE(ids.insert(use->getId()).second);
+
+        // References follow the renamed objects.
+        EXPECT_STREQ(use->getAttribute("xlink:href"), ("#" + std::string(rect->getId())).c_str());
+    }
+}
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Tests for tracing large bitmaps in bands with potrace.
+ */
+#include <cmath>
+#include <gtest/gtest.h>
+#include <2geom/pathvector.h>
+#include <2geom/sbasis-geometric.h>
+
+#include "async/progress.h"
+#include "trace/potrace/inkscape-potrace.h"
+
+using namespace Inkscape::Trace;
+using namespace Inkscape::Trace::Potrace;
+
+namespace {
+
+// Bands of a 2048 pixel wide image are 512 rows high.
+int constexpr WIDTH = 2048;
+int constexpr BAND_HEIGHT = 512;
+
+struct Disc
+{
+    int cx, cy, r;
+    int hole = 0;
+};
+
+// A disc across each of the first three seams, the last with a hole in it that is cut by the seam too.
+Disc const discs[] = {
+    {600, 512, 150},
+    {1400, 1024, 200},
+    {1000, 1536, 180, 90},
+};
+
+GrayMap draw_discs(int height)
+{
+    auto gm = GrayMap(WIDTH, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            bool black = false;
+            for (auto const &d : discs) {
+                int const dist2 = (x - d.cx) * (x - d.cx) + (y - d.cy) * (y - d.cy);
+                black |= dist2 <= d.r * d.r && dist2 > d.hole * d.hole;
+            }
+            gm.setPixel(x, y, black ? GrayMap::BLACK : GrayMap::WHITE);
+        }
+    }
+    return gm;
+}
+
+Geom::PathVector trace(GrayMap const &gm)
+{
+    auto engine = PotraceTracingEngine();
+    auto progress = Inkscape::Async::ProgressAlways<double>();
+    auto result = engine.traceGrayMap(gm, progress);
+    return result.empty() ? Geom::PathVector() : result.front().path;
+}
+
+double area(Geom::PathVector const &pathv)
+{
+    Geom::Point centroid;
+    double area = 0.0;
+    Geom::centroid(Geom::paths_to_pw(pathv), centroid, area);
+    return std::abs(area);
+}
+
+bool on_seam(Geom::Point const &p)
+{
+    return std::abs(p.y() - std::round(p.y() / BAND_HEIGHT) * BAND_HEIGHT) < 0.01;
+}
+
+} // namespace
+
+TEST(PotraceTest, TiledTraceMatchesUntiled)
+{
+    // Just over the 4 megapixels above which tracing is done in bands, and just under it with the same drawing.
+    auto const tiled = trace(draw_discs(2064));
+    auto const untiled = trace(draw_discs(1800));
+    ASSERT_EQ(untiled.size(), 4u);
+
+    // The pieces of each outline are joined back together, with no extra slivers left along the seams.
+    EXPECT_EQ(tiled.size(), untiled.size());
+    EXPECT_NEAR(area(tiled), area(untiled), 1e-3 * area(untiled));
+
+    // Where an outline crosses a seam, the pieces from either side meet in a single point rather than
+    // leaving a small step along the seam.
+    for (auto const &path : tiled) {
+        for (auto const &curve : path) {
+            auto const a = curve.initialPoint();
+            auto const b = curve.finalPoint();
+            EXPECT_FALSE(on_seam(a) && on_seam(b) && Geom::distance(a, b) > 0.01)
+                << "step along the seam from " << a << " to " << b;
+        }
+    }
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: expandtab:shiftwidth=4:tabstop=8:softtabstop=4 :
@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Tests for the binary cache of parsed documents
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <gtest/gtest.h>
+#include <glib.h>
+#include <glibmm/miscutils.h>
+
+#include "preferences.h"
+#include "xml/document.h"
+#include "xml/repr.h"
+#include "xml/repr-cache.h"
+
+using namespace Inkscape;
+using namespace Inkscape::XML;
+
+namespace {
+
+struct DocumentDeleter
+{
+    void operator()(Document *doc) const { GC::release(doc); }
+};
+using DocumentPtr = std::unique_ptr<Document, DocumentDeleter>;
+
+std::string serialize(Document *doc)
+{
+    return sp_repr_save_buf(doc).raw();
+}
+
+} // namespace
+
+class ReprCacheTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        auto const tmp = g_dir_make_tmp("inkscape-repr-cache-XXXXXX", nullptr);
+        ASSERT_TRUE(tmp);
+        dir = tmp;
+        g_free(tmp);
+
+        // Keep the cache out of the real user cache directory. This only works if nothing has
+        // asked for the cache directory yet.
+        g_setenv("XDG_CACHE_HOME", dir.c_str(), true);
+    }
+
+    static void TearDownTestSuite()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+    }
+
+    void SetUp() override
+    {
+        if (Glib::get_user_cache_dir() != dir) {
+            GTEST_SKIP() << "user cache directory was already initialised";
+        }
+
+        Preferences::get()->setBool("/options/documentcache/enabled", true);
+
+        std::error_code ec;
+        std::filesystem::remove_all(entries_dir(), ec);
+
+        // Large enough to be cached, with a namespace that is not one of the default ones.
+        filename = Glib::build_filename(dir, "large.svg");
+        auto out = std::ofstream(filename);
+        out << R"(<svg xmlns="http://www.w3.org/2000/svg" xmlns:foo="http://example.com/ns/foo" width="100" height="100">)" "\n";
+        out << "<!-- comment -->\n<text><![CDATA[cdata]]></text>\n";
+        for (int i = 0; i < 20000; i++) {
+            out << "<rect id=\"r" << i << "\" x=\"" << i % 100 << "\" y=\"1\" width=\"2\" height=\"3\" foo:bar=\"baz" << i % 7 << "\"/>\n";
+        }
+        out << "</svg>\n";
+    }
+
+    static std::string entries_dir()
+    {
+        return Glib::build_filename(dir, "inkscape", "documents");
+    }
+
+    // The single entry in the cache, or an empty path.
+    static std::filesystem::path entry()
+    {
+        std::error_code ec;
+        std::filesystem::path result;
+        for (auto const &e : std::filesystem::directory_iterator(entries_dir(), ec)) {
+            EXPECT_TRUE(result.empty());
+            result = e.path();
+        }
+        return result;
+    }
+
+    // Parse the file normally and store it in the cache.
+    DocumentPtr parse_and_store()
+    {
+        auto const scope = DocumentCache::Scope(filename);
+        auto doc = DocumentPtr(sp_repr_read_file(filename.c_str(), SP_SVG_NS_URI));
+        EXPECT_TRUE(doc);
+        EXPECT_FALSE(entry().empty());
+        return doc;
+    }
+
+    // Load from the cache alone, without falling back to parsing.
+    DocumentPtr load_cached()
+    {
+        auto const scope = DocumentCache::Scope(filename);
+        auto cache = DocumentCache::open(filename.c_str(), SP_SVG_NS_URI, false);
+        EXPECT_TRUE(cache);
+        return DocumentPtr(cache ? cache->load() : nullptr);
+    }
+
+    static inline std::string dir;
+    std::string filename;
+};
+
+TEST_F(ReprCacheTest, roundTripMatchesParse)
+{
+    auto parsed = parse_and_store();
+    ASSERT_TRUE(parsed);
+
+    auto cached = load_cached();
+    ASSERT_TRUE(cached);
+
+    auto const text = serialize(cached.get());
+    EXPECT_EQ(text, serialize(parsed.get()));
+    EXPECT_NE(text.find(R"(xmlns:foo="http://example.com/ns/foo")"), std::string::npos);
+    EXPECT_NE(text.find(R"(foo:bar="baz3")"), std::string::npos);
+    EXPECT_NE(text.find("<![CDATA[cdata]]>"), std::string::npos);
+
+    // Reading the file again goes through the cache and gives the same result.
+    auto const scope = DocumentCache::Scope(filename);
+    auto reread = DocumentPtr(sp_repr_read_file(filename.c_str(), SP_SVG_NS_URI));
+    ASSERT_TRUE(reread);
+    EXPECT_EQ(serialize(reread.get()), text);
+}
+
+TEST_F(ReprCacheTest, onlyScopedFileIsCached)
+{
+    auto doc = DocumentPtr(sp_repr_read_file(filename.c_str(), SP_SVG_NS_URI));
+    ASSERT_TRUE(doc);
+    EXPECT_TRUE(entry().empty());
+    EXPECT_FALSE(DocumentCache::open(filename.c_str(), SP_SVG_NS_URI, false));
+}
+
+TEST_F(ReprCacheTest, truncatedEntryIsDiscarded)
+{
+    auto parsed = parse_and_store();
+    auto const path = entry();
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+    EXPECT_FALSE(load_cached());
+    EXPECT_FALSE(std::filesystem::exists(path));
+
+    // Falls back to parsing.
+    auto const scope = DocumentCache::Scope(filename);
+    auto reread = DocumentPtr(sp_repr_read_file(filename.c_str(), SP_SVG_NS_URI));
+    ASSERT_TRUE(reread);
+    EXPECT_EQ(serialize(reread.get()), serialize(parsed.get()));
+}
+
+TEST_F(ReprCacheTest, corruptEntryIsDiscarded)
+{
+    auto parsed = parse_and_store();
+    auto const path = entry();
+    auto const size = std::filesystem::file_size(path);
+
+    auto corrupt = [&] (std::streamoff offset) {
+        auto f = std::fstream(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(offset);
+        for (int i = 0; i < 16; i++) {
+            f.put('\xff');
+        }
+    };
+
+    // Header
+    corrupt(0);
+    EXPECT_FALSE(load_cached());
+    EXPECT_FALSE(std::filesystem::exists(path));
+
+    // End of the node data
+    parse_and_store();
+    corrupt(size - 16);
+    EXPECT_FALSE(load_cached());
+    EXPECT_FALSE(std::filesystem::exists(path));
+
+    // Trailing garbage
+    parse_and_store();
+    std::ofstream(path, std::ios::app | std::ios::binary) << "garbage";
+    EXPECT_FALSE(load_cached());
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -12,6 +12,7 @@
 #include <gtest/gtest.h>
 
 #include <2geom/pathvector.h>
+#include <2geom/transforms.h>
 
 #include "document.h"
 #include "inkscape.h"
@@ -80,3 +81,72 @@ TEST_F(SPItemTest, getClipPathVector)
     auto pathv4 = r_item->getClipPathVector(r_parent);
     ASSERT_EQ(sp_svg_write_path(*pathv4), "M 13.166016,13.166016 V 40.837891 H 40.837891 V 13.166016 Z");
 }
+
+TEST_F(SPItemTest, cachedBoundsFollowEdits)
+{
+    constexpr auto svg = R"""(<?xml version="1.0"?>
+<svg width="100" height="100">
+  <g id="outer" transform="translate(10,10)">
+    <g id="inner" transform="scale(2)">
+      <rect id="rect" x="0" y="0" width="10" height="10" style="stroke:black;stroke-width:2" />
+    </g>
+  </g>
+</svg>)"""sv;
+
+    auto doc = SPDocument::createNewDocFromMem(svg, true);
+    doc->ensureUpToDate();
+
+    auto outer = cast<SPItem>(doc->getObjectById("outer"));
+    auto rect = cast<SPItem>(doc->getObjectById("rect"));
+
+    EXPECT_EQ(rect->i2doc_affine(), i2anc_affine(rect, nullptr));
+    EXPECT_EQ(*outer->documentGeometricBounds(), Geom::Rect(10, 10, 30, 30));
+    EXPECT_EQ(*outer->documentVisualBounds(), Geom::Rect(8, 8, 32, 32));
+
+    // Changes that request an update are picked up straight away, before the document is updated.
+    outer->setAttribute("transform", "translate(20,20)");
+    EXPECT_EQ(rect->i2doc_affine(), i2anc_affine(rect, nullptr));
+    EXPECT_EQ(*rect->documentGeometricBounds(), Geom::Rect(20, 20, 40, 40));
+    EXPECT_EQ(*outer->documentGeometricBounds(), Geom::Rect(20, 20, 40, 40));
+
+    rect->setAttribute("width", "5");
+    doc->ensureUpToDate();
+    EXPECT_EQ(*outer->documentGeometricBounds(), Geom::Rect(20, 20, 30, 40));
+
+    EXPECT_EQ(*rect->documentGeometricBounds(), Geom::Rect(20, 20, 30, 40));
+
+    // So are direct changes to the transform of the item or its ancestors, even without a request.
+    outer->transform = Geom::Translate(0, 0);
+    EXPECT_EQ(rect->i2doc_affine(), i2anc_affine(rect, nullptr));
+    EXPECT_EQ(*rect->documentGeometricBounds(), Geom::Rect(0, 0, 10, 20));
+    EXPECT_EQ(*outer->documentGeometricBounds(), Geom::Rect(0, 0, 10, 20));
+}
+
+TEST_F(SPItemTest, cachedBoundsFollowChildTransforms)
+{
+    constexpr auto svg = R"""(<?xml version="1.0"?>
+<svg width="100" height="100">
+  <g id="outer" transform="translate(10,10)">
+    <g id="inner" transform="scale(2)">
+      <rect id="rect" x="0" y="0" width="10" height="10" />
+    </g>
+  </g>
+</svg>)"""sv;
+
+    auto doc = SPDocument::createNewDocFromMem(svg, true);
+    doc->ensureUpToDate();
+
+    auto outer = cast<SPItem>(doc->getObjectById("outer"));
+    auto inner = cast<SPItem>(doc->getObjectById("inner"));
+    auto rect = cast<SPItem>(doc->getObjectById("rect"));
+
+    EXPECT_EQ(*outer->documentGeometricBounds(), Geom::Rect(10, 10, 30, 30));
+
+    // The cached bounds of the ancestors include the children, so they follow a change to a child's transform.
+    inner->set_item_transform(Geom::Scale(3));
+    EXPECT_EQ(*outer->documentGeometricBounds(), Geom::Rect(10, 10, 40, 40));
+
+    rect->doWriteTransform(Geom::Translate(5, 0));
+    EXPECT_EQ(*outer->documentGeometricBounds(), Geom::Rect(25, 10, 55, 40));
+    EXPECT_EQ(*inner->documentGeometricBounds(), Geom::Rect(25, 10, 55, 40));
+}
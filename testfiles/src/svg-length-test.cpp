@@ -10,6 +10,13 @@
 #include "svg/svg-length.h"
 #include "svg/svg.h"
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
 #include <glib.h>
 #include <gtest/gtest.h>
 
@@ -71,6 +78,63 @@ eq_test_t eq_tests[4] = {
     {"20mm", "10mm", false},
 };
 
+// The original number writer, kept as a reference for the optimised one.
+std::string reference_write_d(double val, unsigned int tprec, unsigned int fprec)
+{
+    std::string buf;
+    if (val < 0.0) {
+        buf.append("-");
+        val = std::fabs(val);
+    }
+    int idigits = 0;
+    if (val >= 1.0) {
+        idigits = (int)std::floor(std::log10(val)) + 1;
+    }
+    fprec = std::max(static_cast<int>(fprec), static_cast<int>(tprec) - idigits);
+    val += 0.5 / std::pow(10.0, fprec);
+    double dival = std::floor(val);
+    double fval = val - dival;
+    if (idigits > (int)tprec) {
+        buf.append(std::to_string((unsigned int)std::floor(dival / std::pow(10.0, idigits - tprec) + .5)));
+        for (unsigned int j = 0; j < (unsigned int)idigits - tprec; j++) {
+            buf.append("0");
+        }
+    } else {
+        buf.append(std::to_string((unsigned int)dival));
+    }
+    if (fprec > 0 && fval > 0.0) {
+        std::string s(".");
+        do {
+            fval *= 10.0;
+            dival = std::floor(fval);
+            fval -= dival;
+            int const int_dival = (int)dival;
+            s.append(std::to_string(int_dival));
+            if (int_dival != 0) {
+                buf.append(s);
+                s = "";
+            }
+            fprec -= 1;
+        } while (fprec > 0 && fval > 0.0);
+    }
+    return buf;
+}
+
+std::string reference_write_de(double val, unsigned int tprec, int min_exp)
+{
+    int eval = (int)std::floor(std::log10(std::fabs(val)));
+    if (val == 0.0 || eval < min_exp) {
+        return "0";
+    }
+    unsigned int maxnumdigitsWithoutExp = eval < 0 ? tprec + (unsigned int)-eval + 1 : eval + 1 < (int)tprec ? tprec + 1 : (unsigned int)eval + 1;
+    unsigned int maxnumdigitsWithExp = tprec + (eval < 0 ? 4 : 3);
+    if (maxnumdigitsWithoutExp <= maxnumdigitsWithExp) {
+        return reference_write_d(val, tprec, 0);
+    }
+    val = eval < 0 ? val * std::pow(10.0, -eval) : val / std::pow(10.0, eval);
+    return reference_write_d(val, tprec, 0) + "e" + std::to_string(eval);
+}
+
 } // namespace
 
 TEST(SvgLengthTest, testRead)
@@ -230,6 +294,65 @@ TEST(SvgLengthTest, testPlaces)
     }
 }
 
-// TODO: More tests
+TEST(SvgLengthTest, testNumberWriteMatchesReference)
+{
+    auto gen = std::mt19937_64(1);
+    auto mantissa = std::uniform_real_distribution<double>(-10.0, 10.0);
+    auto exponent = std::uniform_int_distribution<int>(-12, 12);
+    auto prec = std::uniform_int_distribution<int>(1, 16);
+
+    for (int i = 0; i < 200000; i++) {
+        // Mix arbitrary doubles with values that are already rounded, as found in path data.
+        auto val = mantissa(gen) * std::pow(10.0, exponent(gen));
+        if (i % 2) {
+            val = std::round(val * 1000.0) / 1000.0;
+        }
+        auto const p = prec(gen);
+        auto const minexp = -8 - (i % 3) * 4;
+        ASSERT_EQ(sp_svg_number_write_de(val, p, minexp), reference_write_de(val, p, minexp)) << val << " " << p << " " << minexp;
+    }
+}
+
+TEST(SvgLengthTest, testNumberReadMatchesStrtod)
+{
+    char const *strings[] = {
+        "0", "-0", "+1", "1.", ".5", "-.5", "1e5", "1E-5", "1e", "1e+", "2.5e+3px", "12,34", " 1", "+-1",
+        "-+1", ".", "-", "e5", "0x1p3", "0x", "inf", "-infinity", "nan", "1e400", "1e-400", "4.9e-324",
+        "2.2250738585072011e-308", "179769313486231580793728971405301e276", "0.1000000000000000055511151231257827",
+        "9007199254740993", "1.00000000000000011102230246251565404236316680908203125",
+    };
+
+    auto check = [] (char const *str) {
+        double expected = -1.0;
+        char *end;
+        auto const v = g_ascii_strtod(str, &end);
+        bool const ok = end != str;
+        if (ok) {
+            expected = v;
+        }
+        double actual = -1.0;
+        ASSERT_EQ(sp_svg_number_read_d(str, &actual), ok ? 1u : 0u) << str;
+        ASSERT_EQ(std::memcmp(&actual, &expected, sizeof(double)), 0) << str;
+    };
+
+    for (auto str : strings) {
+        check(str);
+    }
+
+    auto gen = std::mt19937_64(1);
+    auto bits = std::uniform_int_distribution<std::uint64_t>();
+    auto prec = std::uniform_int_distribution<int>(1, 17);
+
+    for (int i = 0; i < 200000; i++) {
+        auto val = std::bit_cast<double>(bits(gen));
+        if (!std::isfinite(val)) {
+            continue;
+        }
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), i % 2 ? "%.*e" : "%.*g", prec(gen), val);
+        check(buf);
+        check(sp_svg_number_write_de(val, prec(gen), -400).c_str());
+    }
+}
 
 // vim: filetype=cpp:expandtab:shiftwidth=4:softtabstop=4:fileencoding=utf-8:textwidth=99 :
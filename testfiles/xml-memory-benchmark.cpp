@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * XML tree memory benchmark.
+ *
+ * Reads SVG files into XML trees, without building documents on top of them, and reports how
+ * much of the collected heap the trees take, next to the number of nodes and attributes in them.
+ * The heap holds the nodes, their attribute vectors and observer lists, and the shared attribute
+ * and text strings.
+ *
+ * Usage: xml_memory_benchmark [FILE...]
+ * Without arguments, the largest SVG files of the test suite are read.
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2026 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+#include "inkgc/gc-core.h"
+#include "xml/repr.h"
+#include "xml/simple-node.h"
+
+namespace {
+
+struct Counts
+{
+    std::size_t nodes = 0;
+    std::size_t elements = 0;
+    std::size_t attributes = 0;
+};
+
+void count(Inkscape::XML::Node const &node, Counts &counts)
+{
+    counts.nodes++;
+    if (node.type() == Inkscape::XML::NodeType::ELEMENT_NODE) {
+        counts.elements++;
+        counts.attributes += node.attributeList().size();
+    }
+    for (auto child = node.firstChild(); child; child = child->next()) {
+        count(*child, counts);
+    }
+}
+
+std::size_t heap_in_use()
+{
+    Inkscape::GC::Core::gcollect();
+    return Inkscape::GC::Core::get_heap_size() - Inkscape::GC::Core::get_free_bytes();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Inkscape::GC::init();
+
+    std::vector<std::string> files(argv + 1, argv + argc);
+    if (files.empty()) {
+        for (auto name : {"lpe_tests/Inkscape_1_1.svg", "lpe_tests/Inkscape_1_2.svg", "lpe_tests/Inkscape_1_3.svg",
+                          "lpe_tests/Inkscape_1_4.svg", "cli_tests/testcases/pdfinput/multi-page-sample_expected.svg"}) {
+            files.emplace_back(std::string(INKSCAPE_TESTS_DIR) + "/" + name);
+        }
+    }
+
+    if (Inkscape::GC::Core::get_heap_size() == 0) {
+        std::fprintf(stderr, "the garbage collector is disabled, heap sizes are not available\n");
+        return 1;
+    }
+
+    std::printf("sizeof(SimpleNode) %zu bytes\n", sizeof(Inkscape::XML::SimpleNode));
+    std::printf("%-40s %8s %8s %8s %12s %10s\n", "file", "nodes", "elements", "attrs", "heap bytes", "per node");
+
+    for (auto const &file : files) {
+        auto const before = heap_in_use();
+        auto doc = sp_repr_read_file(file.c_str(), SP_SVG_NS_URI);
+        if (!doc) {
+            std::fprintf(stderr, "failed to read %s\n", file.c_str());
+            continue;
+        }
+        auto const after = heap_in_use();
+
+        Counts counts;
+        count(*doc, counts);
+
+        auto const used = after > before ? after - before : 0;
+        auto const name = g_path_get_basename(file.c_str());
+        std::printf("%-40s %8zu %8zu %8zu %12zu %10.1f\n", name, counts.nodes, counts.elements,
+                    counts.attributes, used, static_cast<double>(used) / counts.nodes);
+        g_free(name);
+
+        Inkscape::GC::release(doc);
+    }
+
+    return 0;
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: expandtab:shiftwidth=4:tabstop=8:softtabstop=4 :